@@ -934,6 +934,191 @@ static void test_FDICopy(void)
     FDIDestroy(hfdi);
 }
 
+#define MSZIP_DATA_SIZE 200000
+
+static char *mszip_data;
+static UINT mszip_pos, mszip_size;
+
+static UINT CDECL fdi_mszip_write(INT_PTR hf, void *pv, UINT cb)
+{
+    ok(hf == 0x12345678, "expected 0x12345678, got %#Ix\n", hf);
+    ok(mszip_pos + cb <= mszip_size, "too much data written, %u + %u\n", mszip_pos, cb);
+    if (mszip_pos + cb > mszip_size) return -1;
+
+    ok(!memcmp(pv, mszip_data + mszip_pos, cb), "data mismatch at offset %u\n", mszip_pos);
+    mszip_pos += cb;
+    return cb;
+}
+
+static INT_PTR CDECL fdi_mszip_notify(FDINOTIFICATIONTYPE fdint, FDINOTIFICATION *info)
+{
+    switch (fdint)
+    {
+    case fdintCOPY_FILE:
+        ok(!strcmp(info->psz1, "mszip.dat"), "got %s\n", info->psz1);
+        ok(info->cb == mszip_size, "got %lu\n", info->cb);
+        return 0x12345678;
+
+    case fdintCLOSE_FILE_INFO:
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+static void test_FDICopy_mszip(void)
+{
+    static CHAR mszip_dat[] = "mszip.dat";
+    char name[] = "extract.cab";
+    char path[MAX_PATH + 1];
+    CCAB cabParams;
+    HANDLE file;
+    DWORD written;
+    HFDI hfdi;
+    HFCI hfci;
+    ERF erf;
+    BOOL ret;
+    UINT i;
+
+    /* compressible data spanning several MSZIP blocks */
+    mszip_data = HeapAlloc(GetProcessHeap(), 0, MSZIP_DATA_SIZE);
+    for (i = 0; i < MSZIP_DATA_SIZE; i++)
+        mszip_data[i] = 'a' + (i * 7 + i / 1000) % 26;
+
+    file = CreateFileA(mszip_dat, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+    ok(file != INVALID_HANDLE_VALUE, "failed to create %s\n", mszip_dat);
+    WriteFile(file, mszip_data, MSZIP_DATA_SIZE, &written, NULL);
+    CloseHandle(file);
+
+    set_cab_parameters(&cabParams);
+
+    hfci = FCICreate(&erf, file_placed, mem_alloc, mem_free, fci_open,
+                     fci_read, fci_write, fci_close, fci_seek,
+                     fci_delete, get_temp_file, &cabParams, NULL);
+    ok(hfci != NULL, "Failed to create an FCI context\n");
+
+    add_file(hfci, mszip_dat);
+
+    ret = FCIFlushCabinet(hfci, FALSE, get_next_cabinet, progress);
+    ok(ret, "Failed to flush the cabinet\n");
+    FCIDestroy(hfci);
+
+    lstrcpyA(path, CURR_DIR);
+    lstrcatA(path, "\\");
+
+    hfdi = FDICreate(fdi_alloc, fdi_free, fdi_open, fdi_read,
+                     fdi_mszip_write, fdi_close, fdi_seek,
+                     cpuUNKNOWN, &erf);
+    ok(hfdi != NULL, "FDICreate error %d\n", erf.erfOper);
+
+    mszip_pos = 0;
+    mszip_size = MSZIP_DATA_SIZE;
+    ret = FDICopy(hfdi, name, path, 0, fdi_mszip_notify, NULL, 0);
+    ok(ret, "FDICopy error %d\n", erf.erfOper);
+    ok(mszip_pos == MSZIP_DATA_SIZE, "got %u bytes\n", mszip_pos);
+
+    FDIDestroy(hfdi);
+
+    DeleteFileA(name);
+    DeleteFileA(mszip_dat);
+    HeapFree(GetProcessHeap(), 0, mszip_data);
+}
+
+
+/* MSZIP cabinet with three 256 byte blocks, laid out the way makecab writes
+ * them. The second block is the first one with its 16 byte runs in reverse
+ * order and the third one is the second with every 32nd letter in upper case,
+ * so both are mostly made of matches reaching back into the previous block. */
+static const unsigned char mszip_cab[] =
+{
+    0x4d, 0x53, 0x43, 0x46, 0x00, 0x00, 0x00, 0x00, 0x53, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x01, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x25, 0x12, 0x13, 0x20,
+    0x46, 0x00, 0x00, 0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x03, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x25, 0x12, 0x13, 0x20, 0x20, 0x00,
+    0x6d, 0x73, 0x7a, 0x69, 0x70, 0x2e, 0x64, 0x61, 0x74, 0x00, 0xcb, 0x8b,
+    0x46, 0x4c, 0xaa, 0x00, 0x00, 0x01, 0x43, 0x4b, 0x05, 0xc1, 0x0b, 0x02,
+    0x44, 0x11, 0x08, 0x00, 0xc0, 0xb3, 0x26, 0x92, 0xe8, 0xf9, 0xaf, 0x38,
+    0xfd, 0xce, 0x80, 0xbe, 0x2a, 0xbe, 0x55, 0x35, 0x7d, 0xc9, 0xd1, 0xe5,
+    0xcc, 0x5d, 0xfc, 0xd2, 0x37, 0x51, 0xdd, 0xe6, 0x1b, 0x47, 0xea, 0x54,
+    0xd0, 0xa5, 0xe1, 0xee, 0x50, 0x06, 0x61, 0x7d, 0x65, 0x58, 0xc6, 0x73,
+    0xe8, 0x0a, 0x91, 0x0f, 0x7a, 0xcb, 0x8e, 0x4d, 0x73, 0xb7, 0x16, 0x4b,
+    0x38, 0xf6, 0xa6, 0xfc, 0x62, 0x2e, 0x79, 0x67, 0xbe, 0x69, 0xe5, 0x2d,
+    0x31, 0x8c, 0xab, 0x60, 0x04, 0x1d, 0x95, 0x5a, 0x19, 0xeb, 0x0b, 0xb0,
+    0x3b, 0x5e, 0xd6, 0x39, 0x27, 0x63, 0x4b, 0x7a, 0x28, 0x8d, 0xed, 0x82,
+    0x62, 0x82, 0xd9, 0x5e, 0x6c, 0xbb, 0xe7, 0x60, 0x5e, 0xac, 0xe7, 0x72,
+    0xeb, 0xea, 0x84, 0x9f, 0x73, 0xe0, 0x96, 0xa0, 0x19, 0x5e, 0xd7, 0xe7,
+    0xf1, 0x16, 0xbb, 0x01, 0x33, 0x87, 0xf3, 0x25, 0x04, 0x25, 0x4c, 0xee,
+    0x59, 0x85, 0x28, 0x85, 0xe6, 0x80, 0xb9, 0x06, 0x32, 0xe8, 0xc9, 0x55,
+    0x83, 0xad, 0xe4, 0xfd, 0x1d, 0xe2, 0x30, 0xb1, 0xe0, 0xe1, 0x42, 0xf8,
+    0x48, 0xda, 0xfe, 0xe5, 0x31, 0x3f, 0xab, 0x7f, 0x2f, 0x22, 0x6b, 0x8e,
+    0x2b, 0x00, 0x00, 0x01, 0x43, 0x4b, 0x43, 0xe7, 0xa3, 0xab, 0x47, 0x37,
+    0x0f, 0xdd, 0x3e, 0x74, 0xf7, 0xa0, 0xbb, 0x17, 0xdd, 0x3f, 0xe8, 0xfe,
+    0x45, 0x0f, 0x0f, 0xf4, 0xf0, 0x42, 0x0f, 0x4f, 0xf4, 0xf0, 0x46, 0x8f,
+    0x0f, 0xf4, 0xf8, 0x42, 0x8f, 0xcf, 0x44, 0xb4, 0xf8, 0x06, 0x00, 0xdd,
+    0x1f, 0xae, 0x3a, 0x20, 0x00, 0x00, 0x01, 0x43, 0x4b, 0xf3, 0x20, 0xe0,
+    0x7f, 0x1f, 0x02, 0xfe, 0x77, 0x26, 0xe0, 0xff, 0x60, 0x02, 0xfe, 0x0f,
+    0x20, 0xe0, 0xff, 0x70, 0x02, 0xfe, 0xf7, 0x22, 0xe0, 0x7f, 0x0f, 0x02,
+    0xfe, 0x07, 0x00,
+};
+
+static void fill_mszip_dict_data(char *data)
+{
+    unsigned int seed = 12345;
+    UINT i;
+
+    for (i = 0; i < 256; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        data[i] = 'a' + (seed >> 16) % 26;
+    }
+    for (i = 0; i < 256; i++)
+        data[256 + i] = data[(15 - i / 16) * 16 + i % 16];
+    for (i = 0; i < 256; i++)
+        data[512 + i] = data[256 + i] - (i % 32 ? 0 : 'a' - 'A');
+}
+
+static INT_PTR CDECL fdi_mszip_mem_open(char *name, int oflag, int pmode)
+{
+    struct mem_data *data;
+
+    ok(!strcmp(name, "memory\\mszip"), "got %s\n", name);
+
+    data = HeapAlloc(GetProcessHeap(), 0, sizeof(*data));
+    if (!data) return -1;
+
+    data->base = (const char *)mszip_cab;
+    data->size = sizeof(mszip_cab);
+    data->pos = 0;
+    return (INT_PTR)data;
+}
+
+static void test_FDICopy_mszip_dict(void)
+{
+    char memory[] = "memory\\";
+    char cab[] = "mszip";
+    HFDI hfdi;
+    ERF erf;
+    BOOL ret;
+
+    mszip_size = 3 * 256;
+    mszip_data = HeapAlloc(GetProcessHeap(), 0, mszip_size);
+    fill_mszip_dict_data(mszip_data);
+
+    hfdi = FDICreate(fdi_alloc, fdi_free, fdi_mszip_mem_open, fdi_mem_read,
+                     fdi_mszip_write, fdi_mem_close, fdi_mem_seek, cpuUNKNOWN, &erf);
+    ok(hfdi != NULL, "FDICreate error %d\n", erf.erfOper);
+
+    mszip_pos = 0;
+    ret = FDICopy(hfdi, cab, memory, 0, fdi_mszip_notify, NULL, 0);
+    ok(ret, "FDICopy error %d\n", erf.erfOper);
+    ok(mszip_pos == mszip_size, "got %u bytes\n", mszip_pos);
+
+    FDIDestroy(hfdi);
+    HeapFree(GetProcessHeap(), 0, mszip_data);
+}
+
 
 START_TEST(fdi)
 {
@@ -947,4 +1132,6 @@ START_TEST(fdi)
     test_FDIDestroy();
     test_FDIIsCabinet();
     test_FDICopy();
+    test_FDICopy_mszip();
+    test_FDICopy_mszip_dict();
 }
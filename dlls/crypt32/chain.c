@@ -248,10 +248,109 @@ void WINAPI CertFreeCertificateChainEngine(HCERTCHAINENGINE hChainEngine)
     free_chain_engine(get_chain_engine(hChainEngine, FALSE));
 }
 
+/* Signatures that have already been verified.  Whether a signature is valid
+ * only depends on the encoded subject and on the issuer, so entries never
+ * become stale; they are only replaced when their slot is needed.
+ */
+#define SIGNATURE_CACHE_SIZE 64
+
+struct verified_signature
+{
+    CRYPT_DATA_BLOB subject;
+    CRYPT_DATA_BLOB issuer;
+};
+
+static struct verified_signature signature_cache[SIGNATURE_CACHE_SIZE];
+
+static CRITICAL_SECTION signature_cache_cs;
+static CRITICAL_SECTION_DEBUG signature_cache_cs_debug =
+{
+    0, 0, &signature_cache_cs,
+    { &signature_cache_cs_debug.ProcessLocksList,
+    &signature_cache_cs_debug.ProcessLocksList },
+    0, 0, { (DWORD_PTR)(__FILE__ ": signature_cache_cs") }
+};
+static CRITICAL_SECTION signature_cache_cs = { &signature_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static inline BOOL blob_matches_cert(const CRYPT_DATA_BLOB *blob, const CERT_CONTEXT *cert)
+{
+    return blob->cbData == cert->cbCertEncoded &&
+     !memcmp(blob->pbData, cert->pbCertEncoded, blob->cbData);
+}
+
+static struct verified_signature *get_signature_cache_entry(const CERT_CONTEXT *subject)
+{
+    /* The encoding ends with the signature itself, which is as well
+     * distributed as any hash of it would be.
+     */
+    DWORD index;
+
+    if (subject->cbCertEncoded < sizeof(DWORD))
+        return &signature_cache[0];
+    memcpy(&index, subject->pbCertEncoded + subject->cbCertEncoded - sizeof(DWORD), sizeof(index));
+    return &signature_cache[index % SIGNATURE_CACHE_SIZE];
+}
+
+static BOOL CRYPT_VerifyCertSignature(DWORD encodingType, const CERT_CONTEXT *subject,
+ const CERT_CONTEXT *issuer)
+{
+    struct verified_signature *entry;
+    BYTE *subject_copy, *issuer_copy;
+    BOOL ret;
+
+    EnterCriticalSection(&signature_cache_cs);
+    entry = get_signature_cache_entry(subject);
+    ret = blob_matches_cert(&entry->subject, subject) && blob_matches_cert(&entry->issuer, issuer);
+    LeaveCriticalSection(&signature_cache_cs);
+    if (ret)
+    {
+        TRACE_(chain)("signature of %p already verified\n", subject);
+        return TRUE;
+    }
+
+    if (!CryptVerifyCertificateSignatureEx(0, encodingType,
+     CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT, (void *)subject,
+     CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT, (void *)issuer, 0, NULL))
+        return FALSE;
+
+    /* Only valid signatures are remembered, failures are cheap to find again */
+    subject_copy = CryptMemAlloc(subject->cbCertEncoded);
+    issuer_copy = CryptMemAlloc(issuer->cbCertEncoded);
+    if (subject_copy && issuer_copy)
+    {
+        memcpy(subject_copy, subject->pbCertEncoded, subject->cbCertEncoded);
+        memcpy(issuer_copy, issuer->pbCertEncoded, issuer->cbCertEncoded);
+
+        EnterCriticalSection(&signature_cache_cs);
+        entry = get_signature_cache_entry(subject);
+        CryptMemFree(entry->subject.pbData);
+        CryptMemFree(entry->issuer.pbData);
+        entry->subject.pbData = subject_copy;
+        entry->subject.cbData = subject->cbCertEncoded;
+        entry->issuer.pbData = issuer_copy;
+        entry->issuer.cbData = issuer->cbCertEncoded;
+        LeaveCriticalSection(&signature_cache_cs);
+    }
+    else
+    {
+        CryptMemFree(subject_copy);
+        CryptMemFree(issuer_copy);
+    }
+    return TRUE;
+}
+
 void default_chain_engine_free(void)
 {
+    DWORD i;
+
     free_chain_engine(default_cu_engine);
     free_chain_engine(default_lm_engine);
+
+    for (i = 0; i < SIGNATURE_CACHE_SIZE; i++)
+    {
+        CryptMemFree(signature_cache[i].subject.pbData);
+        CryptMemFree(signature_cache[i].issuer.pbData);
+    }
 }
 
 typedef struct _CertificateChain
@@ -489,9 +588,7 @@ static void CRYPT_CheckRootCert(HCERTSTORE hRoot,
 {
     PCCERT_CONTEXT root = rootElement->pCertContext;
 
-    if (!CryptVerifyCertificateSignatureEx(0, root->dwCertEncodingType,
-     CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT, (void *)root,
-     CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT, (void *)root, 0, NULL))
+    if (!CRYPT_VerifyCertSignature(root->dwCertEncodingType, root, root))
     {
         TRACE_(chain)("Last certificate's signature is invalid\n");
         rootElement->TrustStatus.dwErrorStatus |=
@@ -1909,11 +2006,9 @@ static void CRYPT_CheckSimpleChain(CertificateChainEngine *engine,
         if (i != 0)
         {
             /* Check the signature of the cert this issued */
-            if (!CryptVerifyCertificateSignatureEx(0, X509_ASN_ENCODING,
-             CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT,
-             (void *)chain->rgpElement[i - 1]->pCertContext,
-             CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT,
-             (void *)chain->rgpElement[i]->pCertContext, 0, NULL))
+            if (!CRYPT_VerifyCertSignature(X509_ASN_ENCODING,
+             chain->rgpElement[i - 1]->pCertContext,
+             chain->rgpElement[i]->pCertContext))
                 chain->rgpElement[i - 1]->TrustStatus.dwErrorStatus |=
                  CERT_TRUST_IS_NOT_SIGNATURE_VALID;
             /* Once a path length constraint has been violated, every remaining
@@ -1688,6 +1688,81 @@ void copy_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pitch,
     }
 }
 
+/* Conversions between formats made only of 8-bit channels at byte boundaries
+ * are a plain byte shuffle. map[i] is the source byte for destination byte i,
+ * BYTE_MAP_ZERO for unused bits and BYTE_MAP_ONE for channels missing in the
+ * source, which are set to their maximal value like make_argb_color() does.
+ * The padding byte of formats without alpha is filled the same way, so that
+ * e.g. X8R8G8B8 reads back as opaque. */
+#define BYTE_MAP_ZERO -1
+#define BYTE_MAP_ONE  -2
+
+static BOOL init_byte_map(const struct pixel_format_desc *src_format,
+        const struct pixel_format_desc *dst_format, int map[4])
+{
+    unsigned int c, i;
+
+    if (src_format->type != FORMAT_ARGB || dst_format->type != FORMAT_ARGB
+            || src_format->to_rgba || dst_format->from_rgba
+            || src_format->bytes_per_pixel > 4 || dst_format->bytes_per_pixel > 4)
+        return FALSE;
+
+    for (c = 0; c < 4; ++c)
+    {
+        if ((src_format->bits[c] && (src_format->bits[c] != 8 || src_format->shift[c] % 8))
+                || (dst_format->bits[c] && (dst_format->bits[c] != 8 || dst_format->shift[c] % 8)))
+            return FALSE;
+    }
+
+    for (i = 0; i < 4; ++i)
+        map[i] = BYTE_MAP_ZERO;
+    for (c = 0; c < 4; ++c)
+    {
+        if (!dst_format->bits[c])
+            continue;
+        map[dst_format->shift[c] / 8] = src_format->bits[c] ? src_format->shift[c] / 8 : BYTE_MAP_ONE;
+    }
+    if (!dst_format->bits[0])
+    {
+        for (i = 0; i < dst_format->bytes_per_pixel; ++i)
+        {
+            if (map[i] == BYTE_MAP_ZERO)
+                map[i] = BYTE_MAP_ONE;
+        }
+    }
+    return TRUE;
+}
+
+static void convert_row_byte_map(const BYTE *src, UINT src_bpp, BYTE *dst, UINT dst_bpp,
+        UINT width, const int map[4])
+{
+    UINT x, i;
+
+    for (i = 0; i < dst_bpp; ++i)
+    {
+        if (map[i] != (int)i)
+            break;
+    }
+    if (i == dst_bpp && src_bpp == dst_bpp)
+    {
+        memcpy(dst, src, width * dst_bpp);
+        return;
+    }
+
+    for (x = 0; x < width; ++x)
+    {
+        for (i = 0; i < dst_bpp; ++i)
+        {
+            if (map[i] >= 0)
+                dst[i] = src[map[i]];
+            else
+                dst[i] = map[i] == BYTE_MAP_ONE ? 0xff : 0;
+        }
+        src += src_bpp;
+        dst += dst_bpp;
+    }
+}
+
 /************************************************************
  * convert_argb_pixels
  *
@@ -1705,6 +1780,8 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
     DWORD channels[4];
     UINT min_width, min_height, min_depth;
     UINT x, y, z;
+    BOOL use_byte_map;
+    int byte_map[4];
 
     TRACE("src %p, src_row_pitch %u, src_slice_pitch %u, src_size %p, src_format %p, dst %p, "
             "dst_row_pitch %u, dst_slice_pitch %u, dst_size %p, dst_format %p, color_key 0x%08lx, palette %p.\n",
@@ -1713,6 +1790,7 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
 
     ZeroMemory(channels, sizeof(channels));
     init_argb_conversion_info(src_format, dst_format, &conv_info);
+    use_byte_map = !color_key && init_byte_map(src_format, dst_format, byte_map);
 
     min_width = min(src_size->width, dst_size->width);
     min_height = min(src_size->height, dst_size->height);
@@ -1733,7 +1811,16 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
             const BYTE *src_ptr = src_slice_ptr + y * src_row_pitch;
             BYTE *dst_ptr = dst_slice_ptr + y * dst_row_pitch;
 
-            for (x = 0; x < min_width; x++) {
+            x = 0;
+            if (use_byte_map)
+            {
+                convert_row_byte_map(src_ptr, src_format->bytes_per_pixel, dst_ptr, dst_format->bytes_per_pixel,
+                        min_width, byte_map);
+                dst_ptr += min_width * dst_format->bytes_per_pixel;
+                x = min_width;
+            }
+
+            for (; x < min_width; x++) {
                 if (!src_format->to_rgba && !dst_format->from_rgba
                         && src_format->type == dst_format->type
                         && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
@@ -2029,6 +2116,69 @@ static const char *debug_d3dx_pixels(struct d3dx_pixels *pixels)
             pixels->size.width, pixels->size.height, pixels->size.depth, wine_dbgstr_rect(&pixels->unaligned_rect));
 }
 
+/* Rows of blocks are independent from each other, so large surfaces are
+ * compressed in bands spread over the thread pool. */
+#define DXTN_BAND_HEIGHT 64
+
+struct dxtn_compress_context
+{
+    const BYTE *src;
+    BYTE *dst;
+    uint32_t width, height, dst_row_pitch;
+    GLenum format;
+    LONG next_band;
+    LONG band_count;
+};
+
+static void CALLBACK dxtn_compress_bands(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
+{
+    struct dxtn_compress_context *ctx = context;
+    uint32_t y;
+    LONG band;
+
+    while ((band = InterlockedIncrement(&ctx->next_band) - 1) < ctx->band_count)
+    {
+        y = band * DXTN_BAND_HEIGHT;
+        tx_compress_dxtn(4, ctx->width, min(DXTN_BAND_HEIGHT, ctx->height - y), ctx->src + y * ctx->width * 4,
+                ctx->format, ctx->dst + (y / 4) * ctx->dst_row_pitch, ctx->dst_row_pitch);
+    }
+}
+
+static void compress_dxtn(const BYTE *src, uint32_t width, uint32_t height, GLenum format,
+        BYTE *dst, uint32_t dst_row_pitch)
+{
+    struct dxtn_compress_context ctx;
+    unsigned int i, worker_count;
+    SYSTEM_INFO info;
+    TP_WORK *work;
+
+    ctx.src = src;
+    ctx.dst = dst;
+    ctx.width = width;
+    ctx.height = height;
+    ctx.dst_row_pitch = dst_row_pitch;
+    ctx.format = format;
+    ctx.next_band = 0;
+    ctx.band_count = (height + DXTN_BAND_HEIGHT - 1) / DXTN_BAND_HEIGHT;
+
+    GetSystemInfo(&info);
+    worker_count = min(info.dwNumberOfProcessors, (DWORD)ctx.band_count);
+    if (worker_count <= 1 || (uint64_t)width * height < 256 * 256
+            || !(work = CreateThreadpoolWork(dxtn_compress_bands, &ctx, NULL)))
+    {
+        dxtn_compress_bands(NULL, &ctx, NULL);
+        return;
+    }
+
+    TRACE("Compressing %ld bands using %u threads.\n", ctx.band_count, worker_count);
+    /* the calling thread takes its share of the bands too */
+    for (i = 1; i < worker_count; ++i)
+        SubmitThreadpoolWork(work);
+    dxtn_compress_bands(NULL, &ctx, NULL);
+    WaitForThreadpoolWorkCallbacks(work, FALSE);
+    CloseThreadpoolWork(work);
+}
+
 HRESULT d3dx_load_pixels_from_pixels(struct d3dx_pixels *dst_pixels,
        const struct pixel_format_desc *dst_desc, struct d3dx_pixels *src_pixels,
        const struct pixel_format_desc *src_desc, uint32_t filter_flags, uint32_t color_key)
@@ -2153,7 +2303,7 @@ HRESULT d3dx_load_pixels_from_pixels(struct d3dx_pixels *dst_pixels,
                 BYTE *uncompressed_mem_slice = (BYTE *)uncompressed_mem + (i * uncompressed_slice_pitch);
                 BYTE *dst_memory_slice = ((BYTE *)dst_pixels->data) + (i * dst_pixels->slice_pitch);
 
-                tx_compress_dxtn(4, dst_size_aligned.width, dst_size_aligned.height, uncompressed_mem_slice, gl_format,
+                compress_dxtn(uncompressed_mem_slice, dst_size_aligned.width, dst_size_aligned.height, gl_format,
                         dst_memory_slice, dst_pixels->row_pitch);
             }
         }
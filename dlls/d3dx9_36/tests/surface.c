@@ -1730,6 +1730,127 @@ static void test_D3DXLoadSurface(IDirect3DDevice9 *device)
     if(testbitmap_ok) DeleteFileA("testbitmap.bmp");
 }
 
+static void test_format_conversion(IDirect3DDevice9 *device)
+{
+    static const DWORD argb_pixel = 0x11223344;
+    static const BYTE rgb_pixel[] = {0x44, 0x33, 0x22};
+    static const struct
+    {
+        D3DFORMAT src_format;
+        const void *src;
+        D3DFORMAT dst_format;
+        DWORD expected;
+    }
+    tests[] =
+    {
+        {D3DFMT_A8R8G8B8, &argb_pixel, D3DFMT_A8B8G8R8, 0x11443322},
+        {D3DFMT_A8R8G8B8, &argb_pixel, D3DFMT_X8R8G8B8, 0xff223344},
+        {D3DFMT_R8G8B8,   rgb_pixel,   D3DFMT_X8R8G8B8, 0xff223344},
+        {D3DFMT_R8G8B8,   rgb_pixel,   D3DFMT_A8R8G8B8, 0xff223344},
+        {D3DFMT_A8R8G8B8, &argb_pixel, D3DFMT_A8,       0x11},
+    };
+    D3DLOCKED_RECT lockrect;
+    IDirect3DSurface9 *surf;
+    unsigned int i;
+    DWORD color;
+    HRESULT hr;
+    RECT rect;
+
+    SetRect(&rect, 0, 0, 1, 1);
+    for (i = 0; i < ARRAY_SIZE(tests); ++i)
+    {
+        winetest_push_context("Test %u", i);
+
+        hr = IDirect3DDevice9_CreateOffscreenPlainSurface(device, 1, 1, tests[i].dst_format,
+                D3DPOOL_SCRATCH, &surf, NULL);
+        if (FAILED(hr))
+        {
+            skip("Failed to create surface, format %#x, hr %#lx.\n", tests[i].dst_format, hr);
+            winetest_pop_context();
+            continue;
+        }
+
+        hr = D3DXLoadSurfaceFromMemory(surf, NULL, NULL, tests[i].src, tests[i].src_format, 4, NULL,
+                &rect, D3DX_FILTER_NONE, 0);
+        ok(hr == D3D_OK, "Got unexpected hr %#lx.\n", hr);
+
+        hr = IDirect3DSurface9_LockRect(surf, &lockrect, NULL, D3DLOCK_READONLY);
+        ok(hr == D3D_OK, "Got unexpected hr %#lx.\n", hr);
+        if (tests[i].dst_format == D3DFMT_A8)
+            color = *(BYTE *)lockrect.pBits;
+        else
+            color = *(DWORD *)lockrect.pBits;
+        ok(color == tests[i].expected, "Got color 0x%08lx, expected 0x%08lx.\n", color, tests[i].expected);
+        IDirect3DSurface9_UnlockRect(surf);
+
+        check_release((IUnknown *)surf, 0);
+        winetest_pop_context();
+    }
+}
+
+static void test_dxtn_compression_bands(IDirect3DDevice9 *device)
+{
+    static const D3DFORMAT formats[] = {D3DFMT_DXT1, D3DFMT_DXT5};
+    static const unsigned int size = 512, band_height = 64;
+    D3DLOCKED_RECT whole_rect, bands_rect;
+    IDirect3DSurface9 *whole, *bands;
+    unsigned int i, x, y, row_size;
+    DWORD *pixels;
+    RECT rect;
+    HRESULT hr;
+
+    pixels = malloc(size * size * sizeof(*pixels));
+    for (y = 0; y < size; ++y)
+    {
+        for (x = 0; x < size; ++x)
+            pixels[y * size + x] = ((x * 7 + y) & 0xff) << 24 | (x & 0xff) << 16 | (y & 0xff) << 8 | ((x ^ y) & 0xff);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(formats); ++i)
+    {
+        winetest_push_context("Format %#x", formats[i]);
+
+        hr = IDirect3DDevice9_CreateOffscreenPlainSurface(device, size, size, formats[i], D3DPOOL_SCRATCH, &whole, NULL);
+        ok(hr == D3D_OK, "Got unexpected hr %#lx.\n", hr);
+        hr = IDirect3DDevice9_CreateOffscreenPlainSurface(device, size, size, formats[i], D3DPOOL_SCRATCH, &bands, NULL);
+        ok(hr == D3D_OK, "Got unexpected hr %#lx.\n", hr);
+
+        /* Surfaces this large may be compressed in parallel, small bands never are. */
+        SetRect(&rect, 0, 0, size, size);
+        hr = D3DXLoadSurfaceFromMemory(whole, NULL, NULL, pixels, D3DFMT_A8R8G8B8, size * sizeof(*pixels),
+                NULL, &rect, D3DX_FILTER_NONE, 0);
+        ok(hr == D3D_OK, "Got unexpected hr %#lx.\n", hr);
+        for (y = 0; y < size; y += band_height)
+        {
+            SetRect(&rect, 0, y, size, y + band_height);
+            hr = D3DXLoadSurfaceFromMemory(bands, NULL, &rect, pixels, D3DFMT_A8R8G8B8, size * sizeof(*pixels),
+                    NULL, &rect, D3DX_FILTER_NONE, 0);
+            ok(hr == D3D_OK, "Got unexpected hr %#lx.\n", hr);
+        }
+
+        hr = IDirect3DSurface9_LockRect(whole, &whole_rect, NULL, D3DLOCK_READONLY);
+        ok(hr == D3D_OK, "Got unexpected hr %#lx.\n", hr);
+        hr = IDirect3DSurface9_LockRect(bands, &bands_rect, NULL, D3DLOCK_READONLY);
+        ok(hr == D3D_OK, "Got unexpected hr %#lx.\n", hr);
+        row_size = (size / 4) * (formats[i] == D3DFMT_DXT1 ? 8 : 16);
+        for (y = 0; y < size / 4; ++y)
+        {
+            if (memcmp((BYTE *)whole_rect.pBits + y * whole_rect.Pitch,
+                    (BYTE *)bands_rect.pBits + y * bands_rect.Pitch, row_size))
+                break;
+        }
+        ok(y == size / 4, "Block row %u differs.\n", y);
+        IDirect3DSurface9_UnlockRect(bands);
+        IDirect3DSurface9_UnlockRect(whole);
+
+        check_release((IUnknown *)bands, 0);
+        check_release((IUnknown *)whole, 0);
+        winetest_pop_context();
+    }
+
+    free(pixels);
+}
+
 static void test_D3DXSaveSurfaceToFileInMemory(IDirect3DDevice9 *device)
 {
     static const struct
@@ -1993,6 +2114,8 @@ START_TEST(surface)
 
     test_D3DXGetImageInfo();
     test_D3DXLoadSurface(device);
+    test_format_conversion(device);
+    test_dxtn_compression_bands(device);
     test_D3DXSaveSurfaceToFileInMemory(device);
     test_D3DXSaveSurfaceToFile(device);
 
@@ -300,9 +300,41 @@ void hash_table_destroy(struct hash_table* ht)
 #endif
 }
 
+/* average chain length above which the number of buckets is doubled */
+#define HASH_TABLE_MAX_LOAD 4
+
+static void hash_table_grow(struct hash_table* ht)
+{
+    struct hash_table_bucket*   buckets;
+    struct hash_table_elt*      elt;
+    struct hash_table_elt*      next;
+    unsigned                    num_buckets = ht->num_buckets * 2;
+    unsigned                    i, hash;
+
+    /* old bucket array stays in the pool, it's freed along with the module */
+    if (!(buckets = pool_alloc(ht->pool, num_buckets * sizeof(struct hash_table_bucket)))) return;
+    memset(buckets, 0, num_buckets * sizeof(struct hash_table_bucket));
+
+    /* elements of the same name end up in the same bucket, in the same order */
+    for (i = 0; i < ht->num_buckets; i++)
+    {
+        for (elt = ht->buckets[i].first; elt; elt = next)
+        {
+            next = elt->next;
+            hash = hash_table_hash(elt->name, num_buckets);
+            if (!buckets[hash].first) buckets[hash].first = elt;
+            else buckets[hash].last->next = elt;
+            buckets[hash].last = elt;
+            elt->next = NULL;
+        }
+    }
+    ht->buckets = buckets;
+    ht->num_buckets = num_buckets;
+}
+
 void hash_table_add(struct hash_table* ht, struct hash_table_elt* elt)
 {
-    unsigned                    hash = hash_table_hash(elt->name, ht->num_buckets);
+    unsigned                    hash;
 
     if (!ht->buckets)
     {
@@ -310,6 +342,10 @@ void hash_table_add(struct hash_table* ht, struct hash_table_elt* elt)
         assert(ht->buckets);
         memset(ht->buckets, 0, ht->num_buckets * sizeof(struct hash_table_bucket));
     }
+    else if (ht->num_elts >= ht->num_buckets * HASH_TABLE_MAX_LOAD)
+        hash_table_grow(ht);
+
+    hash = hash_table_hash(elt->name, ht->num_buckets);
 
     /* in some cases, we need to get back the symbols of same name in the order
      * in which they've been inserted. So insert new elements at the end of the list.
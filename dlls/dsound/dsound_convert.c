@@ -328,6 +328,35 @@ void mixieee32(float *src, float *dst, unsigned samples)
         *(dst++) += *(src++);
 }
 
+/* Applies the per-channel volume while mixing, instead of scaling the
+ * temporary buffer in a separate pass. */
+void mixieee32_vol(const float *src, float *dst, unsigned frames, unsigned channels, const float *vols)
+{
+    unsigned i, chan;
+
+    TRACE("%p - %p %u %u\n", src, dst, frames, channels);
+
+    if (channels == 2)
+    {
+        float left = vols[0], right = vols[1];
+
+        for (i = 0; i < frames; i++)
+        {
+            dst[2 * i] += src[2 * i] * left;
+            dst[2 * i + 1] += src[2 * i + 1] * right;
+        }
+        return;
+    }
+
+    for (i = 0; i < frames; i++)
+    {
+        for (chan = 0; chan < channels; chan++)
+            dst[chan] += src[chan] * vols[chan];
+        src += channels;
+        dst += channels;
+    }
+}
+
 static void norm8(float *src, unsigned char *dst, unsigned samples)
 {
     TRACE("%p - %p %d\n", src, dst, samples);
@@ -286,6 +286,57 @@ static inline float get_current_sample(const IDirectSoundBufferImpl *dsb,
     return dsb->get(dsb, buffer + (mixpos % buflen), channel);
 }
 
+/* Same as calling get_current_sample() for count consecutive frames of one
+ * channel, without a modulo and looping check for every sample. */
+static void get_channel_samples(const IDirectSoundBufferImpl *dsb, BYTE *buffer, DWORD buflen,
+        DWORD mixpos, DWORD channel, UINT count, float *out)
+{
+    UINT istride = dsb->pwfx->nBlockAlign;
+    UINT i = 0, run;
+
+    while (i < count)
+    {
+        if (mixpos >= buflen)
+        {
+            if (!(dsb->playflags & DSBPLAY_LOOPING))
+            {
+                for (; i < count; i++)
+                    out[i] = 0.0f;
+                return;
+            }
+            mixpos %= buflen;
+        }
+
+        /* number of frames left before wrapping around */
+        run = (buflen - mixpos + istride - 1) / istride;
+        if (run > count - i)
+            run = count - i;
+
+        for (; run; run--, i++, mixpos += istride)
+            out[i] = dsb->get(dsb, buffer + mixpos, channel);
+    }
+}
+
+/* Uses several accumulators so that the compiler can keep them in vector
+ * registers; the FIR is by far the most expensive part of the mixer. */
+static inline float fir_dot_product(const float *coeffs, const float *samples, int len)
+{
+    float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+    int j;
+
+    for (j = 0; j + 4 <= len; j += 4)
+    {
+        sum0 += coeffs[j] * samples[j];
+        sum1 += coeffs[j + 1] * samples[j + 1];
+        sum2 += coeffs[j + 2] * samples[j + 2];
+        sum3 += coeffs[j + 3] * samples[j + 3];
+    }
+    for (; j < len; j++)
+        sum0 += coeffs[j] * samples[j];
+
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
 static UINT cp_fields_noresample(IDirectSoundBufferImpl *dsb, UINT count)
 {
     UINT istride = dsb->pwfx->nBlockAlign;
@@ -362,12 +413,12 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
      */
     itmp = intermediate;
     for (channel = 0; channel < channels; channel++) {
-        for (i = 0; i < committed_samples; i++)
-            *(itmp++) = get_current_sample(dsb, dsb->committedbuff,
-                dsb->writelead, dsb->committed_mixpos + i * istride, channel);
-        for (; i < required_input; i++)
-            *(itmp++) = get_current_sample(dsb, dsb->buffer->memory,
-                    dsb->buflen, dsb->sec_mixpos + i * istride, channel);
+        get_channel_samples(dsb, dsb->committedbuff, dsb->writelead,
+                dsb->committed_mixpos, channel, committed_samples, itmp);
+        get_channel_samples(dsb, dsb->buffer->memory, dsb->buflen,
+                dsb->sec_mixpos + committed_samples * istride, channel,
+                required_input - committed_samples, itmp + committed_samples);
+        itmp += required_input;
     }
 
     for(i = 0; i < count; ++i) {
@@ -388,11 +439,7 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
         assert(ipos + fir_used <= required_input);
 
         for (channel = 0; channel < dsb->mix_channels; channel++) {
-            int j;
-            float sum = 0.0;
-            float* cache = &intermediate[channel * required_input + ipos];
-            for (j = 0; j < fir_used; j++)
-                sum += fir_copy[j] * cache[j];
+            float sum = fir_dot_product(fir_copy, &intermediate[channel * required_input + ipos], fir_used);
             dsb->put(dsb, i * ostride, channel, sum * dsb->firgain);
         }
     }
@@ -485,35 +532,33 @@ static void DSOUND_MixToTemporary(IDirectSoundBufferImpl *dsb, DWORD frames)
 	}
 }
 
-static void DSOUND_MixerVol(const IDirectSoundBufferImpl *dsb, INT frames)
+/**
+ * Get the per-channel volume factors of the buffer.
+ * Returns FALSE when the samples can be mixed unchanged.
+ */
+static BOOL DSOUND_MixerVol(const IDirectSoundBufferImpl *dsb, float *vols)
 {
-	INT	i;
-	float vols[DS_MAX_CHANNELS];
 	UINT channels = dsb->device->pwfx->nChannels, chan;
 
-	TRACE("(%p,%d)\n",dsb,frames);
+	TRACE("(%p)\n",dsb);
 	TRACE("left = %lx, right = %lx\n", dsb->volpan.dwTotalAmpFactor[0],
 		dsb->volpan.dwTotalAmpFactor[1]);
 
 	if ((!(dsb->dsbd.dwFlags & DSBCAPS_CTRLPAN) || (dsb->volpan.lPan == 0)) &&
 	    (!(dsb->dsbd.dwFlags & DSBCAPS_CTRLVOLUME) || (dsb->volpan.lVolume == 0)) &&
 	     !(dsb->dsbd.dwFlags & DSBCAPS_CTRL3D))
-		return; /* Nothing to do */
+		return FALSE; /* Nothing to do */
 
 	if (channels > DS_MAX_CHANNELS)
 	{
 		FIXME("There is no support for %u channels\n", channels);
-		return;
+		return FALSE;
 	}
 
-	for (i = 0; i < channels; ++i)
-		vols[i] = dsb->volpan.dwTotalAmpFactor[i] / ((float)0xFFFF);
+	for (chan = 0; chan < channels; ++chan)
+		vols[chan] = dsb->volpan.dwTotalAmpFactor[chan] / ((float)0xFFFF);
 
-	for(i = 0; i < frames; ++i){
-		for(chan = 0; chan < channels; ++chan){
-			dsb->device->tmp_buffer[i * channels + chan] *= vols[chan];
-		}
-	}
+	return TRUE;
 }
 
 /**
@@ -542,10 +587,14 @@ static DWORD DSOUND_MixInBuffer(IDirectSoundBufferImpl *dsb, float *mix_buffer,
 	ibuf = dsb->device->tmp_buffer;
 
 	if (secondarybuffer_is_audible(dsb)) {
-		/* Apply volume if needed */
-		DSOUND_MixerVol(dsb, frames);
+		UINT channels = dsb->device->pwfx->nChannels;
+		float vols[DS_MAX_CHANNELS];
 
-		mixieee32(ibuf, mix_buffer, frames * dsb->device->pwfx->nChannels);
+		/* Apply volume if needed */
+		if (DSOUND_MixerVol(dsb, vols))
+			mixieee32_vol(ibuf, mix_buffer, frames, channels, vols);
+		else
+			mixieee32(ibuf, mix_buffer, frames * channels);
 	}
 
 	/* check for notification positions */
@@ -24,6 +24,7 @@
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(jscript);
+WINE_DECLARE_DEBUG_CHANNEL(jscript_gc);
 
 static const GUID GUID_JScriptTypeInfo = {0xc59c6b12,0xf6c1,0x11cf,{0x88,0x35,0x00,0xa0,0xc9,0x11,0xe8,0xb2}};
 
@@ -728,7 +729,9 @@ static void unlink_jsdisp(jsdisp_t *jsdisp)
  * objects. Otherwise calculating the "next" object in the list becomes impossible.
  *
  * This collection process has to be done periodically, but can be pretty expensive so there
- * has to be a balance between reclaiming dangling objects and performance.
+ * has to be a balance between reclaiming dangling objects and performance. The cost of a
+ * collection is proportional to the number of live objects, so the periodic collection is
+ * skipped until enough objects were created since the previous one (see gc_should_run).
  *
  */
 struct gc_stack_chunk {
@@ -787,14 +790,18 @@ HRESULT gc_run(script_ctx_t *ctx)
     jsdisp_t *obj, *obj2, *link, *link2;
     dispex_prop_t *prop, *props_end;
     struct gc_ctx gc_ctx = { 0 };
-    unsigned chunk_idx = 0;
+    unsigned chunk_idx = 0, objects_count;
     HRESULT hres = S_OK;
     struct list *iter;
+    DWORD start_tick;
 
     /* Prevent recursive calls from side-effects during unlinking (e.g. CollectGarbage from host object's Release) */
     if(thread_data->gc_is_unlinking)
         return S_OK;
 
+    start_tick = GetTickCount();
+    objects_count = thread_data->objects_count;
+
     if(!(head = malloc(sizeof(*head))))
         return E_OUTOFMEMORY;
     head->next = NULL;
@@ -963,9 +970,27 @@ HRESULT gc_run(script_ctx_t *ctx)
 
     thread_data->gc_is_unlinking = FALSE;
     thread_data->gc_last_tick = GetTickCount();
+    thread_data->gc_allocs = 0;
+    thread_data->gc_survivors = thread_data->objects_count;
+
+    TRACE_(jscript_gc)("%u objects, %u freed, %lu ms\n", objects_count,
+                       objects_count - min(objects_count, thread_data->objects_count),
+                       thread_data->gc_last_tick - start_tick);
     return S_OK;
 }
 
+/* Periodic collections only pay off if the heap has grown enough to possibly contain
+   new garbage; re-traversing a large, stable heap every interval just causes pauses.
+   Still collect eventually, since cycles may also be created between old objects. */
+static BOOL gc_should_run(struct thread_data *thread_data)
+{
+    DWORD elapsed = GetTickCount() - thread_data->gc_last_tick;
+
+    if(elapsed <= 30000)
+        return FALSE;
+    return thread_data->gc_allocs >= thread_data->gc_survivors / 8 || elapsed > 8 * 30000;
+}
+
 HRESULT gc_process_linked_obj(struct gc_ctx *gc_ctx, enum gc_traverse_op op, jsdisp_t *obj, jsdisp_t *link, void **unlink_ref)
 {
     if(op == GC_TRAVERSE_UNLINK) {
@@ -2172,8 +2197,7 @@ HRESULT init_dispex(jsdisp_t *dispex, script_ctx_t *ctx, const builtin_info_t *b
 {
     unsigned i;
 
-    /* FIXME: Use better heuristics to decide when to run the GC */
-    if(GetTickCount() - ctx->thread_data->gc_last_tick > 30000)
+    if(gc_should_run(ctx->thread_data))
         gc_run(ctx);
 
     TRACE("%p (%p)\n", dispex, prototype);
@@ -2201,6 +2225,8 @@ HRESULT init_dispex(jsdisp_t *dispex, script_ctx_t *ctx, const builtin_info_t *b
     dispex->ctx = ctx;
 
     list_add_tail(&ctx->thread_data->objects, &dispex->entry);
+    ctx->thread_data->objects_count++;
+    ctx->thread_data->gc_allocs++;
     return S_OK;
 }
 
@@ -2230,6 +2256,7 @@ void jsdisp_free(jsdisp_t *obj)
     dispex_prop_t *prop;
 
     list_remove(&obj->entry);
+    obj->ctx->thread_data->objects_count--;
 
     TRACE("(%p)\n", obj);
 
@@ -2348,6 +2375,34 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/*
+ * Same as jsdisp_get_id, but first checks the property stored at index *hint,
+ * and updates it on success. Objects created by the same code usually store
+ * their properties at the same indexes, so this allows callers that look up
+ * the same name repeatedly to skip the hashing and prototype chain lookup.
+ */
+HRESULT jsdisp_get_id_hint(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, unsigned *hint, DISPID *id)
+{
+    dispex_prop_t *prop;
+    HRESULT hres;
+
+    if(!(flags & fdexNameCaseInsensitive) && *hint < jsdisp->prop_cnt) {
+        prop = &jsdisp->props[*hint];
+        if(prop->type != PROP_DELETED && !wcscmp(prop->name, name)) {
+            fix_protref_prop(jsdisp, prop);
+            if(prop->type != PROP_DELETED) {
+                *id = prop_to_id(jsdisp, prop);
+                return S_OK;
+            }
+        }
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(SUCCEEDED(hres))
+        *hint = *id - 1;
+    return hres;
+}
+
 HRESULT jsdisp_get_idx_id(jsdisp_t *jsdisp, DWORD idx, DISPID *id)
 {
     WCHAR name[11];
@@ -621,6 +621,17 @@ static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name
     return hres;
 }
 
+static HRESULT disp_get_id_hint(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name, BSTR name_bstr, DWORD flags,
+                                unsigned *hint, DISPID *id)
+{
+    jsdisp_t *jsdisp;
+
+    jsdisp = to_jsdisp(disp);
+    if(jsdisp)
+        return jsdisp_get_id_hint(jsdisp, name, flags, hint, id);
+    return disp_get_id(ctx, disp, name, name_bstr, flags, id);
+}
+
 static HRESULT disp_cmp(IDispatch *disp1, IDispatch *disp2, BOOL *ret)
 {
     IObjectIdentity *identity;
@@ -968,6 +979,13 @@ static inline jsstr_t *get_op_str(script_ctx_t *ctx, int i)
     return frame->bytecode->instrs[frame->ip].u.arg[i].str;
 }
 
+/* member lookup instructions keep the property index hint in their unused second argument */
+static inline unsigned *get_op_prop_hint(script_ctx_t *ctx)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return &frame->bytecode->instrs[frame->ip].u.arg[1].uint;
+}
+
 static inline double get_op_double(script_ctx_t *ctx)
 {
     call_frame_t *frame = ctx->call_ctx;
@@ -1437,7 +1455,7 @@ static HRESULT interp_member(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    hres = disp_get_id_hint(ctx, obj, arg, arg, 0, get_op_prop_hint(ctx), &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1479,7 +1497,7 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, name, NULL, arg, &id);
+    hres = disp_get_id_hint(ctx, obj, name, NULL, arg, get_op_prop_hint(ctx), &id);
     jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         ref.type = EXPRVAL_IDREF;
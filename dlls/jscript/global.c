@@ -129,6 +129,54 @@ static HRESULT JSGlobal_escape(script_ctx_t *ctx, jsval_t vthis, WORD flags, uns
     return S_OK;
 }
 
+/* Scripts often eval the same strings over and over, so keep the most recently
+   compiled code around. Conditional compilation may change the parser state, so
+   don't cache anything once it's enabled. */
+static bytecode_t **get_eval_cache_entry(script_ctx_t *ctx, const WCHAR *src)
+{
+    unsigned hash = 0;
+    const WCHAR *p;
+
+    for(p = src; *p; p++)
+        hash = hash * 31 + *p;
+    return &ctx->eval_cache[hash % ARRAY_SIZE(ctx->eval_cache)];
+}
+
+static HRESULT compile_eval_code(script_ctx_t *ctx, const WCHAR *src, named_item_t *named_item, bytecode_t **ret)
+{
+    bytecode_t **entry = NULL;
+    HRESULT hres;
+
+    if(!ctx->cc) {
+        entry = get_eval_cache_entry(ctx, src);
+        if(*entry && (*entry)->named_item == named_item && !wcscmp((*entry)->source, src)) {
+            *ret = bytecode_addref(*entry);
+            return S_OK;
+        }
+    }
+
+    hres = compile_script(ctx, src, 0, 0, NULL, NULL, TRUE, FALSE, named_item, ret);
+    if(FAILED(hres) || !entry || ctx->cc)
+        return hres;
+
+    if(*entry)
+        release_bytecode(*entry);
+    *entry = bytecode_addref(*ret);
+    return S_OK;
+}
+
+void release_eval_cache(script_ctx_t *ctx)
+{
+    unsigned i;
+
+    for(i = 0; i < ARRAY_SIZE(ctx->eval_cache); i++) {
+        if(ctx->eval_cache[i]) {
+            release_bytecode(ctx->eval_cache[i]);
+            ctx->eval_cache[i] = NULL;
+        }
+    }
+}
+
 /* ECMA-262 3rd Edition    15.1.2.1 */
 HRESULT builtin_eval(script_ctx_t *ctx, call_frame_t *frame, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
@@ -157,7 +205,7 @@ HRESULT builtin_eval(script_ctx_t *ctx, call_frame_t *frame, WORD flags, unsigne
         return E_OUTOFMEMORY;
 
     TRACE("parsing %s\n", debugstr_jsval(argv[0]));
-    hres = compile_script(ctx, src, 0, 0, NULL, NULL, TRUE, FALSE, frame ? frame->bytecode->named_item : NULL, &code);
+    hres = compile_eval_code(ctx, src, frame ? frame->bytecode->named_item : NULL, &code);
     if(FAILED(hres)) {
         WARN("parse (%s) failed: %08lx\n", debugstr_jsval(argv[0]), hres);
         return hres;
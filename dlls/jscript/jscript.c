@@ -77,6 +77,7 @@ void script_release(script_ctx_t *ctx)
         return;
 
     jsval_release(ctx->acc);
+    release_eval_cache(ctx);
     if(ctx->cc)
         release_cc(ctx->cc);
     heap_pool_free(&ctx->tmp_heap);
@@ -473,6 +474,7 @@ static void decrease_state(JScript *This, SCRIPTSTATE state)
         case SCRIPTSTATE_INITIALIZED:
             clear_script_queue(This);
             release_persistent_script_objs(This);
+            release_eval_cache(This->ctx);
 
             LIST_FOR_EACH_ENTRY_SAFE(item, item_next, &This->ctx->named_items, named_item_t, entry)
             {
@@ -137,6 +137,9 @@ struct thread_data {
 
     BOOL gc_is_unlinking;
     DWORD gc_last_tick;
+    unsigned gc_allocs;     /* objects created since the last collection */
+    unsigned gc_survivors;  /* objects alive after the last collection */
+    unsigned objects_count;
 
     struct list objects;
     struct rb_tree weak_refs;
@@ -278,6 +281,7 @@ HRESULT jsdisp_propput_idx(jsdisp_t*,DWORD,jsval_t);
 HRESULT jsdisp_propget_name(jsdisp_t*,LPCWSTR,jsval_t*);
 HRESULT jsdisp_get_idx(jsdisp_t*,DWORD,jsval_t*);
 HRESULT jsdisp_get_id(jsdisp_t*,const WCHAR*,DWORD,DISPID*);
+HRESULT jsdisp_get_id_hint(jsdisp_t*,const WCHAR*,DWORD,unsigned*,DISPID*);
 HRESULT jsdisp_get_idx_id(jsdisp_t*,DWORD,DISPID*);
 HRESULT disp_delete(IDispatch*,DISPID,BOOL*);
 HRESULT disp_delete_name(script_ctx_t*,IDispatch*,jsstr_t*,BOOL*);
@@ -415,6 +419,8 @@ struct _script_ctx_t {
     unsigned stack_top;
     jsval_t acc;
 
+    struct _bytecode_t *eval_cache[16];
+
     jsstr_t *last_match;
     match_result_t match_parens[9];
     DWORD last_match_index;
@@ -506,6 +512,7 @@ HRESULT localize_number(script_ctx_t*,DOUBLE,BOOL,jsstr_t**);
 
 BOOL is_builtin_eval_func(jsdisp_t*);
 HRESULT builtin_eval(script_ctx_t*,struct _call_frame_t*,WORD,unsigned,jsval_t*,jsval_t*);
+void release_eval_cache(script_ctx_t*);
 HRESULT JSGlobal_eval(script_ctx_t*,jsval_t,WORD,unsigned,jsval_t*,jsval_t*);
 HRESULT Object_get_proto_(script_ctx_t*,jsval_t,WORD,unsigned,jsval_t*,jsval_t*);
 HRESULT Object_set_proto_(script_ctx_t*,jsval_t,WORD,unsigned,jsval_t*,jsval_t*);
@@ -3069,16 +3069,29 @@ good:
 
 static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
 {
+    regexp_t *re = gData->regexp;
     match_state_t *result;
     const WCHAR *cp = x->cp;
     const WCHAR *cp2;
+    BOOL anchored;
     UINT j;
 
+    /* without the multiline flag, a leading ^ only matches at the beginning of input */
+    anchored = re->program[0] == REOP_BOL && !(re->flags & REG_MULTILINE);
+
     /*
      * Have to include the position beyond the last character
      * in order to detect end-of-input/line condition.
      */
     for (cp2 = cp; cp2 <= gData->cpend; cp2++) {
+        if (anchored && cp2 != gData->cpbegin)
+            return NULL;
+        if (re->has_first_char && !(re->flags & REG_STICKY)) {
+            /* skip to the next position where a match may start */
+            if (cp2 == gData->cpend ||
+                !(cp2 = wmemchr(cp2, re->first_char, gData->cpend - cp2)))
+                return NULL;
+        }
         gData->skipped = cp2 - cp;
         x->cp = cp2;
         for (j = 0; j < gData->regexp->parenCount; j++)
@@ -3174,6 +3187,37 @@ HRESULT regexp_execute(regexp_t *regexp, void *cx, heap_pool_t *pool,
     return S_OK;
 }
 
+/*
+ * Find a character all matches have to start with, so that positions that
+ * can't match are skipped without running the bytecode.
+ */
+static void FindFirstChar(regexp_t *re)
+{
+    jsbytecode *pc = re->program;
+    size_t index;
+
+    re->has_first_char = FALSE;
+
+    while (*pc == REOP_LPAREN)
+        pc = ReadCompactIndex(pc + 1, &index);
+
+    switch (*pc) {
+      case REOP_FLAT:
+        ReadCompactIndex(pc + 1, &index);
+        re->first_char = re->source[index];
+        break;
+      case REOP_FLAT1:
+        re->first_char = pc[1];
+        break;
+      case REOP_UCFLAT1:
+        re->first_char = GET_ARG(pc + 1);
+        break;
+      default:
+        return;
+    }
+    re->has_first_char = TRUE;
+}
+
 void regexp_destroy(regexp_t *re)
 {
     if (re->classList) {
@@ -3277,6 +3321,7 @@ regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
     re->parenCount = state.parenCount;
     re->source = str;
     re->source_len = str_len;
+    FindFirstChar(re);
 
 out:
     heap_pool_clear(mark);
@@ -2159,3 +2159,62 @@ function test_es5_keywords() {
     ok(tmp === true, "Expected exception for 'const c1 = 1;'");
 }
 test_es5_keywords();
+
+function test_member_lookup_hint() {
+    var objs = [{a: 1, b: 2}, {b: 3, a: 4}, {c: 5}, {a: 6}], o, i, r = "";
+
+    function Proto() {}
+    Proto.prototype.a = 7;
+    objs.push(new Proto());
+
+    o = {a: 8, b: 9};
+    delete o.a;
+    objs.push(o);
+
+    /* the same member expressions are used on objects with different layouts */
+    for(i = 0; i < objs.length; i++)
+        r += objs[i].a + ",";
+    ok(r === "1,4,undefined,6,7,undefined,", "r = " + r);
+
+    o = new Proto();
+    for(i = 0; i < 2; i++) {
+        r = o.a;
+        ok(r === 7 + i, "o.a = " + r);
+        Proto.prototype.a = 8;
+    }
+    delete Proto.prototype.a;
+    ok(o.a === undefined, "o.a = " + o.a);
+
+    o = {x: 1, y: 2};
+    for(i = 0; i < 3; i++) {
+        o.y = i;
+        ok(o.y === i, "o.y = " + o.y);
+        if(i == 1) {
+            delete o.y;
+            o.x = 3;
+        }
+    }
+    ok(o.x === 3, "o.x = " + o.x);
+}
+test_member_lookup_hint();
+
+function test_eval_cache() {
+    var i, f, funcs = [], x = 0;
+
+    /* evaluating the same string again must still run it in the current scope */
+    for(i = 0; i < 3; i++) {
+        eval("x += i;");
+        funcs.push(eval("(function() { return i; })"));
+    }
+    ok(x === 3, "x = " + x);
+    ok(funcs[0] !== funcs[1], "eval returned the same function object");
+    f = funcs[2];
+    ok(f() === 3, "f() = " + f());
+
+    function inner(y) {
+        return eval("y * 2");
+    }
+    ok(inner(2) === 4, "inner(2) = " + inner(2));
+    ok(inner(5) === 10, "inner(5) = " + inner(5));
+}
+test_eval_cache();
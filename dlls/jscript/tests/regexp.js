@@ -732,4 +732,20 @@ ok(re.ignoreCase === false, "re.ignoreCase = " + re.ignoreCase);
 ok(re.multiline === true, "re.multiline = " + re.multiline);
 ok(re.global === true, "re.global = " + re.global);
 
+
+/* matches that have to start with a given character, or at the beginning of input */
+m = "xxabcxabc".match(/(a)bc/g);
+ok(m.length === 2 && m[0] === "abc" && m[1] === "abc", "m = " + m);
+m = /(\u0100)b/.exec("aa\u0100b");
+ok(m.index === 2 && m[1] === "\u0100", "m.index = " + m.index);
+ok("xxab".search(/a/) === 2, "search(/a/) = " + "xxab".search(/a/));
+ok("xxab".search(/c/) === -1, "search(/c/) = " + "xxab".search(/c/));
+ok("aXa".replace(/a/g, "b") === "bXb", "replace = " + "aXa".replace(/a/g, "b"));
+re = /^a/g;
+ok(re.test("aa") === true, "re.test(aa) returned false");
+ok(re.test("aa") === false, "re.test(aa) returned true");
+ok("ba\na".match(/^a/) === null, "match(/^a/) = " + "ba\na".match(/^a/));
+m = "ba\na".match(/^a/m);
+ok(m !== null && m.index === 3, "match(/^a/m) = " + m);
+
 reportSuccess();
@@ -533,6 +533,147 @@ static BOOL installfiles_cb(MSIPACKAGE *package, LPCWSTR filename, DWORD action,
     return TRUE;
 }
 
+/* uncompressed files are copied from the source media by the thread pool */
+#define MAX_PENDING_COPIES 4
+
+struct copy_job
+{
+    struct list entry;
+    MSIPACKAGE *package;
+    MSIFILE *file;
+    WCHAR *source;
+    HANDLE slots;
+    UINT rc;
+    LONG done;
+};
+
+struct file_copier
+{
+    struct list jobs;
+    HANDLE slots;
+    unsigned int copied;
+};
+
+static void init_file_copier( MSIPACKAGE *package, struct file_copier *copier )
+{
+    list_init( &copier->jobs );
+    copier->copied = 0;
+
+    /* file system redirection state is stored in the package and is per thread */
+    if (is_wow64 && package->platform == PLATFORM_X64) copier->slots = NULL;
+    else copier->slots = CreateSemaphoreW( NULL, MAX_PENDING_COPIES, MAX_PENDING_COPIES, NULL );
+}
+
+static void CALLBACK copy_file_callback( TP_CALLBACK_INSTANCE *instance, void *context )
+{
+    struct copy_job *job = context;
+
+    ReleaseSemaphoreWhenCallbackReturns( instance, job->slots, 1 );
+    job->rc = copy_install_file( job->package, job->file, job->source );
+    /* the job may be freed as soon as it's marked as done */
+    WriteRelease( &job->done, TRUE );
+}
+
+static UINT finish_copy_job( struct copy_job *job )
+{
+    UINT rc = job->rc;
+
+    if (rc != ERROR_SUCCESS)
+    {
+        ERR("Failed to copy %s to %s (%u)\n", debugstr_w(job->source), debugstr_w(job->file->TargetPath), rc);
+        rc = ERROR_INSTALL_FAILURE;
+    }
+    else if (!msi_is_global_assembly( job->file->Component )) job->file->state = msifs_installed;
+
+    list_remove( &job->entry );
+    free( job->source );
+    free( job );
+    return rc;
+}
+
+/* update the state of the files installed by the finished copies, returns the first error */
+static UINT reap_file_copies( struct file_copier *copier )
+{
+    struct copy_job *job, *next;
+    UINT rc = ERROR_SUCCESS, ret;
+
+    LIST_FOR_EACH_ENTRY_SAFE( job, next, &copier->jobs, struct copy_job, entry )
+    {
+        if (!ReadAcquire( &job->done )) continue;
+        if ((ret = finish_copy_job( job )) != ERROR_SUCCESS && rc == ERROR_SUCCESS) rc = ret;
+    }
+    return rc;
+}
+
+/* wait for all queued copies and update the state of the files they installed */
+static UINT flush_file_copies( struct file_copier *copier )
+{
+    unsigned int i;
+
+    if (!copier->slots || list_empty( &copier->jobs )) return ERROR_SUCCESS;
+
+    for (i = 0; i < MAX_PENDING_COPIES; i++) WaitForSingleObject( copier->slots, INFINITE );
+    ReleaseSemaphore( copier->slots, MAX_PENDING_COPIES, NULL );
+
+    return reap_file_copies( copier );
+}
+
+static UINT queue_file_copy( struct file_copier *copier, MSIPACKAGE *package, MSIFILE *file, WCHAR *source )
+{
+    struct copy_job *job;
+    UINT rc;
+
+    if (copier->slots)
+    {
+        /* stop at the first failed copy, like the synchronous path does */
+        WaitForSingleObject( copier->slots, INFINITE );
+        if ((rc = reap_file_copies( copier )))
+        {
+            ReleaseSemaphore( copier->slots, 1, NULL );
+            free( source );
+            return rc;
+        }
+    }
+
+    copier->copied++;
+
+    if (!copier->slots || !(job = malloc( sizeof(*job) )))
+    {
+        rc = copy_install_file( package, file, source );
+        if (rc != ERROR_SUCCESS)
+        {
+            ERR("Failed to copy %s to %s (%u)\n", debugstr_w(source), debugstr_w(file->TargetPath), rc);
+            rc = ERROR_INSTALL_FAILURE;
+        }
+        else if (!msi_is_global_assembly( file->Component )) file->state = msifs_installed;
+        free( source );
+        if (copier->slots) ReleaseSemaphore( copier->slots, 1, NULL );
+        return rc;
+    }
+
+    job->package = package;
+    job->file    = file;
+    job->source  = source;
+    job->slots   = copier->slots;
+    job->rc      = ERROR_SUCCESS;
+    job->done    = FALSE;
+    list_add_tail( &copier->jobs, &job->entry );
+
+    if (!TrySubmitThreadpoolCallback( copy_file_callback, job, NULL ))
+    {
+        job->rc = copy_install_file( package, file, source );
+        job->done = TRUE;
+        ReleaseSemaphore( copier->slots, 1, NULL );
+    }
+    return ERROR_SUCCESS;
+}
+
+static void free_file_copier( struct file_copier *copier )
+{
+    flush_file_copies( copier );
+    if (copier->slots) CloseHandle( copier->slots );
+}
+
 WCHAR *msi_resolve_file_source( MSIPACKAGE *package, MSIFILE *file )
 {
     WCHAR *p, *path;
@@ -560,12 +701,17 @@ WCHAR *msi_resolve_file_source( MSIPACKAGE *package, MSIFILE *file )
  * For efficiency, this is done in two passes:
  * 1) Correct all the TargetPaths and determine what files are to be installed.
  * 2) Extract Cabinets and copy files.
+ *
+ * Uncompressed files are copied in the background while the following files
+ * are processed; pending copies are completed before switching media.
  */
 UINT ACTION_InstallFiles(MSIPACKAGE *package)
 {
     MSIMEDIAINFO *mi;
-    UINT rc = ERROR_SUCCESS;
+    UINT rc = ERROR_SUCCESS, disk_id = 0;
     MSIFILE *file;
+    struct file_copier copier;
+    DWORD start;
 
     msi_set_sourcedir_props(package, FALSE);
 
@@ -574,6 +720,8 @@ UINT ACTION_InstallFiles(MSIPACKAGE *package)
 
     schedule_install_files(package);
     mi = calloc(1, sizeof(MSIMEDIAINFO));
+    init_file_copier( package, &copier );
+    start = GetTickCount();
 
     LIST_FOR_EACH_ENTRY( file, &package->files, MSIFILE, entry )
     {
@@ -589,6 +737,12 @@ UINT ACTION_InstallFiles(MSIPACKAGE *package)
             goto done;
         }
 
+        if (mi->disk_id != disk_id || mi->is_continuous)
+        {
+            if ((rc = flush_file_copies( &copier ))) goto done;
+            disk_id = mi->disk_id;
+        }
+
         if (file->state != msifs_hashmatch &&
             file->state != msifs_skipped &&
             (file->state != msifs_present || !msi_get_property_int( package->db, L"Installed", 0 )) &&
@@ -630,16 +784,7 @@ UINT ACTION_InstallFiles(MSIPACKAGE *package)
             {
                 create_folder(package, file->Component->Directory);
             }
-            rc = copy_install_file(package, file, source);
-            if (rc != ERROR_SUCCESS)
-            {
-                ERR("Failed to copy %s to %s (%u)\n", debugstr_w(source), debugstr_w(file->TargetPath), rc);
-                rc = ERROR_INSTALL_FAILURE;
-                free(source);
-                goto done;
-            }
-            if (!is_global_assembly) file->state = msifs_installed;
-            free(source);
+            if ((rc = queue_file_copy( &copier, package, file, source ))) goto done;
         }
         else if (!is_global_assembly && file->state != msifs_installed &&
                  !(file->Attributes & msidbFileAttributesPatchAdded))
@@ -650,7 +795,11 @@ UINT ACTION_InstallFiles(MSIPACKAGE *package)
         }
     }
 
+    rc = flush_file_copies( &copier );
+    TRACE("copied %u uncompressed files in %lu ms\n", copier.copied, GetTickCount() - start);
+
 done:
+    free_file_copier( &copier );
     msi_free_media_info(mi);
     return rc;
 }
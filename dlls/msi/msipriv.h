@@ -226,7 +226,7 @@ typedef struct _column_info
     struct _column_info *next;
 } column_info;
 
-typedef const struct tagMSICOLUMNHASHENTRY *MSIITERHANDLE;
+typedef const struct column_hash_entry *MSIITERHANDLE;
 
 typedef struct tagMSIVIEWOPS
 {
@@ -347,6 +347,17 @@ typedef struct tagMSIVIEWOPS
      * drop - drops the table from the database
      */
     UINT (*drop)( struct tagMSIVIEW *view );
+
+    /*
+     * find_matching_rows - iterates through the rows whose column matches a value
+     *
+     *  The value is compared with what fetch_int returns for the column, so
+     *   string columns are looked up by string ID.
+     *  The handle keeps track of the position in the iteration. It must be
+     *   initialised to NULL before the first call and passed back in on
+     *   subsequent calls. Rows are returned in ascending order.
+     */
+    UINT (*find_matching_rows)( struct tagMSIVIEW *view, UINT col, UINT val, UINT *row, MSIITERHANDLE *handle );
 } MSIVIEWOPS;
 
 struct tagMSIVIEW
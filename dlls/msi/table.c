@@ -55,6 +55,7 @@ struct column_info
     UINT    type;
     UINT    offset;
     struct column_hash_entry **hash_table;
+    UINT    hash_size;
 };
 
 struct tagMSITABLE
@@ -1480,7 +1481,7 @@ static UINT table_create_new_row( struct tagMSIVIEW *view, UINT *num, BOOL tempo
     UINT sz;
     BYTE ***data_ptr;
     BOOL **data_persist_ptr;
-    UINT *row_count;
+    UINT *row_count, i;
 
     TRACE("%p %s\n", view, temporary ? "TRUE" : "FALSE");
 
@@ -1494,6 +1495,13 @@ static UINT table_create_new_row( struct tagMSIVIEW *view, UINT *num, BOOL tempo
     row_count = &tv->table->row_count;
     data_ptr = &tv->table->data;
     data_persist_ptr = &tv->table->data_persistent;
+
+    /* rows after the new one get shifted, so reset the hash tables */
+    for (i = 0; i < tv->num_cols; i++)
+    {
+        free( tv->columns[i].hash_table );
+        tv->columns[i].hash_table = NULL;
+    }
     if (*num == -1)
         *num = tv->table->row_count;
 
@@ -2165,6 +2173,68 @@ done:
     return r;
 }
 
+static UINT TABLE_find_matching_rows( struct tagMSIVIEW *view, UINT col, UINT val, UINT *row,
+                                      MSIITERHANDLE *handle )
+{
+    struct table_view *tv = (struct table_view *)view;
+    struct column_info *column;
+    const struct column_hash_entry *entry;
+
+    TRACE( "%p, %u, %u, %p\n", view, col, val, *handle );
+
+    if (!tv->table)
+        return ERROR_INVALID_PARAMETER;
+
+    if ((col == 0) || (col > tv->num_cols))
+        return ERROR_INVALID_PARAMETER;
+
+    column = &tv->columns[col - 1];
+    if (!column->hash_table)
+    {
+        UINT i, num_rows = tv->table->row_count, size = max( num_rows, MSITABLE_HASH_TABLE_SIZE );
+        struct column_hash_entry **hash_table, *new_entry;
+
+        /* allocate the buckets and the entries together so there's nothing else to free */
+        hash_table = malloc( size * sizeof(*hash_table) + num_rows * sizeof(*new_entry) );
+        if (!hash_table)
+            return ERROR_OUTOFMEMORY;
+
+        memset( hash_table, 0, size * sizeof(*hash_table) );
+        new_entry = (struct column_hash_entry *)(hash_table + size);
+
+        /* insert backwards so that each chain is sorted by row */
+        for (i = num_rows; i > 0; i--)
+        {
+            UINT value;
+
+            if (TABLE_fetch_int( view, i - 1, col, &value ) != ERROR_SUCCESS)
+                continue;
+
+            new_entry->value = value;
+            new_entry->row = i - 1;
+            new_entry->next = hash_table[value % size];
+            hash_table[value % size] = new_entry++;
+        }
+        column->hash_table = hash_table;
+        column->hash_size = size;
+    }
+
+    if (!*handle)
+        entry = column->hash_table[val % column->hash_size];
+    else
+        entry = (*handle)->next;
+
+    while (entry && entry->value != val)
+        entry = entry->next;
+
+    *handle = entry;
+    if (!entry)
+        return ERROR_NO_MORE_ITEMS;
+
+    *row = entry->row;
+    return ERROR_SUCCESS;
+}
+
 static const MSIVIEWOPS table_ops =
 {
     TABLE_fetch_int,
@@ -2186,6 +2256,7 @@ static const MSIVIEWOPS table_ops =
     TABLE_add_column,
     NULL,
     TABLE_drop,
+    TABLE_find_matching_rows,
 };
 
 UINT TABLE_CreateView( MSIDATABASE *db, LPCWSTR name, MSIVIEW **view )
@@ -2762,6 +2833,7 @@ static const MSIVIEWOPS transform_view_ops =
     NULL,
     NULL,
     NULL,
+    NULL,
     NULL
 };
 
@@ -9365,6 +9365,115 @@ static void test_viewfetch_wraparound(void)
     DeleteFileA(msifile);
 }
 
+static UINT count_query_rows( MSIHANDLE hdb, MSIHANDLE hrec, const char *query, UINT *count )
+{
+    MSIHANDLE hview, rec;
+    UINT r;
+
+    *count = 0;
+    r = MsiDatabaseOpenViewA( hdb, query, &hview );
+    if (r != ERROR_SUCCESS)
+        return r;
+    r = MsiViewExecute( hview, hrec );
+    while (r == ERROR_SUCCESS && (r = MsiViewFetch( hview, &rec )) == ERROR_SUCCESS)
+    {
+        (*count)++;
+        MsiCloseHandle( rec );
+    }
+    MsiViewClose( hview );
+    MsiCloseHandle( hview );
+    return r == ERROR_NO_MORE_ITEMS ? ERROR_SUCCESS : r;
+}
+
+static void test_where_index(void)
+{
+    static const struct
+    {
+        const char *query;
+        const char *str;
+        int val;
+        UINT count;
+    }
+    tests[] =
+    {
+        { "SELECT `K` FROM `T` WHERE `S` = 'a'", NULL, 0, 2 },
+        { "SELECT `K` FROM `T` WHERE `S` = 'z'", NULL, 0, 0 },
+        { "SELECT `K` FROM `T` WHERE `V` = 10", NULL, 0, 2 },
+        { "SELECT `K` FROM `T` WHERE `S` = ?", "c", 0, 1 },
+        { "SELECT `K` FROM `T` WHERE `V` = ? AND `S` = ?", "a", 30, 1 },
+        { "SELECT `K` FROM `T` WHERE `S` = 'a' OR `V` = 20", NULL, 0, 3 },
+        { "SELECT `T`.`K` FROM `T`, `U` WHERE `T`.`S` = `U`.`S`", NULL, 0, 3 },
+        { "SELECT `T`.`K` FROM `U`, `T` WHERE `U`.`W` = 1 AND `U`.`S` = `T`.`S`", NULL, 0, 2 },
+    };
+    MSIHANDLE hdb, rec;
+    UINT r, i, count;
+
+    hdb = create_db();
+    ok( hdb, "failed to create db\n" );
+
+    r = run_query( hdb, 0, "CREATE TABLE `T` ( `K` INT, `S` CHAR(32), `V` INT PRIMARY KEY `K` )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = run_query( hdb, 0, "CREATE TABLE `U` ( `S` CHAR(32), `W` INT PRIMARY KEY `S` )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = run_query( hdb, 0, "INSERT INTO `T` ( `K`, `S`, `V` ) VALUES ( 1, 'a', 10 )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = run_query( hdb, 0, "INSERT INTO `T` ( `K`, `S`, `V` ) VALUES ( 2, 'b', 20 )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = run_query( hdb, 0, "INSERT INTO `T` ( `K`, `S`, `V` ) VALUES ( 3, 'a', 30 )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = run_query( hdb, 0, "INSERT INTO `T` ( `K`, `S`, `V` ) VALUES ( 4, 'c', 10 )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = run_query( hdb, 0, "INSERT INTO `U` ( `S`, `W` ) VALUES ( 'a', 1 )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = run_query( hdb, 0, "INSERT INTO `U` ( `S`, `W` ) VALUES ( 'b', 2 )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+
+    for (i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        rec = MsiCreateRecord( 2 );
+        if (tests[i].val)
+        {
+            MsiRecordSetInteger( rec, 1, tests[i].val );
+            MsiRecordSetStringA( rec, 2, tests[i].str );
+        }
+        else if (tests[i].str)
+            MsiRecordSetStringA( rec, 1, tests[i].str );
+
+        r = count_query_rows( hdb, rec, tests[i].query, &count );
+        ok( r == ERROR_SUCCESS, "%u: got %u\n", i, r );
+        ok( count == tests[i].count, "%u: got %u rows\n", i, count );
+        MsiCloseHandle( rec );
+    }
+
+    /* the same queries have to see modifications of the table */
+    r = run_query( hdb, 0, "INSERT INTO `T` ( `K`, `S`, `V` ) VALUES ( 0, 'a', 40 )" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = count_query_rows( hdb, 0, "SELECT `K` FROM `T` WHERE `S` = 'a'", &count );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    ok( count == 3, "got %u rows\n", count );
+
+    r = run_query( hdb, 0, "UPDATE `T` SET `S` = 'b' WHERE `K` = 1" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = count_query_rows( hdb, 0, "SELECT `K` FROM `T` WHERE `S` = 'a'", &count );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    ok( count == 2, "got %u rows\n", count );
+    r = count_query_rows( hdb, 0, "SELECT `K` FROM `T` WHERE `S` = 'b'", &count );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    ok( count == 2, "got %u rows\n", count );
+
+    r = run_query( hdb, 0, "DELETE FROM `T` WHERE `K` = 3" );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    r = count_query_rows( hdb, 0, "SELECT `K` FROM `T` WHERE `S` = 'a'", &count );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    ok( count == 1, "got %u rows\n", count );
+    r = count_query_rows( hdb, 0, "SELECT `K` FROM `T` WHERE `V` = 40", &count );
+    ok( r == ERROR_SUCCESS, "got %u\n", r );
+    ok( count == 1, "got %u rows\n", count );
+
+    MsiCloseHandle( hdb );
+    DeleteFileA( msifile );
+}
+
 START_TEST(db)
 {
     test_msidatabase();
@@ -9425,4 +9534,5 @@ START_TEST(db)
     test_viewmodify_insert();
     test_view_get_error();
     test_viewfetch_wraparound();
+    test_where_index();
 }
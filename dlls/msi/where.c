@@ -51,6 +51,11 @@ struct join_table
     UINT col_count;
     UINT row_count;
     UINT table_index;
+    /* equality with one of our columns that the rows must satisfy, see find_index_key */
+    const struct expr *index_value;
+    UINT index_column;
+    int index_type;
+    UINT index_wildcard;
 };
 
 typedef struct tagMSIORDERINFO
@@ -647,16 +652,85 @@ static UINT WHERE_evaluate( MSIWHEREVIEW *wv, const UINT rows[],
     return ERROR_SUCCESS;
 }
 
+/* computes the value to look up in the index of the table, returns FALSE if the
+ * rows have to be scanned instead */
+static BOOL get_index_key( MSIWHEREVIEW *wv, const struct join_table *table, const UINT rows[],
+                           MSIRECORD *record, UINT *key, BOOL *no_match )
+{
+    const struct expr *value = table->index_value;
+    const WCHAR *str;
+
+    *no_match = FALSE;
+    if (!value || !table->view->ops->find_matching_rows)
+        return FALSE;
+
+    switch (value->type)
+    {
+    case EXPR_UVAL:
+        *key = value->u.uval + (table->index_type == EXPR_COL_NUMBER32 ? 0x80000000 : 0x8000);
+        return TRUE;
+
+    case EXPR_COL_NUMBER:
+    case EXPR_COL_NUMBER32:
+        return expr_fetch_value( &value->u.column, rows, key ) == ERROR_SUCCESS;
+
+    case EXPR_COL_NUMBER_STRING:
+        /* null strings compare equal to empty ones */
+        return expr_fetch_value( &value->u.column, rows, key ) == ERROR_SUCCESS && *key;
+
+    case EXPR_SVAL:
+        str = value->u.sval;
+        break;
+
+    case EXPR_WILDCARD:
+        if (!record)
+            return FALSE;
+        str = MSI_RecordGetString( record, table->index_wildcard );
+        break;
+
+    default:
+        return FALSE;
+    }
+
+    if (!str || !*str)
+        return FALSE;
+    if (msi_string2id( wv->db->strings, str, -1, key ) != ERROR_SUCCESS)
+        *no_match = TRUE;
+    return TRUE;
+}
+
 static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, struct join_table **tables,
                              UINT table_rows[] )
 {
-    UINT r = ERROR_FUNCTION_FAILED;
+    struct join_table *table = *tables;
+    MSIITERHANDLE handle = NULL;
+    BOOL use_index, no_match;
+    UINT r = ERROR_FUNCTION_FAILED, key, row = 0;
     INT val;
 
-    for (table_rows[(*tables)->table_index] = 0;
-         table_rows[(*tables)->table_index] < (*tables)->row_count;
-         table_rows[(*tables)->table_index]++)
+    if ((use_index = get_index_key( wv, table, table_rows, record, &key, &no_match )))
     {
+        r = ERROR_SUCCESS;
+        if (no_match)
+            return r;
+    }
+
+    for (;;)
+    {
+        if (use_index)
+        {
+            UINT res = table->view->ops->find_matching_rows( table->view, table->index_column, key,
+                                                             &row, &handle );
+            if (res != ERROR_SUCCESS)
+            {
+                if (res != ERROR_NO_MORE_ITEMS) r = res;
+                break;
+            }
+        }
+        else if (row >= table->row_count)
+            break;
+
+        table_rows[table->table_index] = row++;
         val = 0;
         wv->rec_index = 0;
         r = WHERE_evaluate( wv, table_rows, wv->cond, &val, record );
@@ -678,7 +752,7 @@ static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, struct join_ta
             }
         }
     }
-    table_rows[(*tables)->table_index] = INVALID_ROW_INDEX;
+    table_rows[table->table_index] = INVALID_ROW_INDEX;
     return r;
 }
 
@@ -786,6 +860,88 @@ static UINT reorder_check( const struct expr *expr, struct join_table **ordered_
     }
 }
 
+static UINT count_wildcards( const struct expr *expr )
+{
+    switch (expr->type)
+    {
+    case EXPR_WILDCARD:
+        return 1;
+    case EXPR_COMPLEX:
+    case EXPR_STRCMP:
+        return count_wildcards( expr->u.expr.left ) + count_wildcards( expr->u.expr.right );
+    default:
+        return 0;
+    }
+}
+
+static BOOL is_index_value( const struct expr *value, const struct expr *column,
+                            struct join_table **bound, UINT bound_count )
+{
+    UINT i;
+
+    switch (value->type)
+    {
+    case EXPR_UVAL:
+        return column->type != EXPR_COL_NUMBER_STRING;
+    case EXPR_SVAL:
+    case EXPR_WILDCARD:
+        return column->type == EXPR_COL_NUMBER_STRING;
+    case EXPR_COL_NUMBER:
+    case EXPR_COL_NUMBER32:
+    case EXPR_COL_NUMBER_STRING:
+        if (value->type != column->type)
+            return FALSE;
+        for (i = 0; i < bound_count; i++)
+            if (bound[i] == value->u.column.parsed.table) return TRUE;
+        return FALSE;
+    default:
+        return FALSE;
+    }
+}
+
+/* Looks for an equality between a column of the table and a value that is known once
+ * the tables before it are bound, and which has to hold for the whole condition to be
+ * true. Wildcards are numbered in evaluation order, so keep track of how many come
+ * before the expression. */
+static BOOL find_index_key( const struct expr *cond, struct join_table *table,
+                            struct join_table **bound, UINT bound_count, UINT wildcards )
+{
+    const struct expr *left, *right;
+
+    if (cond->type != EXPR_COMPLEX && cond->type != EXPR_STRCMP)
+        return FALSE;
+
+    left = cond->u.expr.left;
+    right = cond->u.expr.right;
+    if (cond->type == EXPR_COMPLEX && cond->u.expr.op == OP_AND)
+        return find_index_key( left, table, bound, bound_count, wildcards ) ||
+               find_index_key( right, table, bound, bound_count, wildcards + count_wildcards( left ) );
+    if (cond->u.expr.op != OP_EQ)
+        return FALSE;
+
+    if ((left->type == EXPR_COL_NUMBER || left->type == EXPR_COL_NUMBER32 ||
+         left->type == EXPR_COL_NUMBER_STRING) && left->u.column.parsed.table == table &&
+        is_index_value( right, left, bound, bound_count ))
+    {
+        table->index_value = right;
+        table->index_column = left->u.column.parsed.column;
+        table->index_type = left->type;
+        table->index_wildcard = wildcards + count_wildcards( left ) + 1;
+        return TRUE;
+    }
+    if ((right->type == EXPR_COL_NUMBER || right->type == EXPR_COL_NUMBER32 ||
+         right->type == EXPR_COL_NUMBER_STRING) && right->u.column.parsed.table == table &&
+        is_index_value( left, right, bound, bound_count ))
+    {
+        table->index_value = left;
+        table->index_column = right->u.column.parsed.column;
+        table->index_type = right->type;
+        table->index_wildcard = wildcards + 1;
+        return TRUE;
+    }
+    return FALSE;
+}
+
 /* reorders the tablelist in a way to evaluate the condition as fast as possible */
 static struct join_table **ordertables( MSIWHEREVIEW *wv )
 {
@@ -847,6 +1003,13 @@ static UINT WHERE_execute( struct tagMSIVIEW *view, MSIRECORD *record )
 
     ordered_tables = ordertables( wv );
 
+    for (i = 0; i < wv->table_count; i++)
+    {
+        ordered_tables[i]->index_value = NULL;
+        if (wv->cond)
+            find_index_key( wv->cond, ordered_tables[i], ordered_tables, i, 0 );
+    }
+
     rows = malloc(wv->table_count * sizeof(*rows));
     for (i = 0; i < wv->table_count; i++)
         rows[i] = INVALID_ROW_INDEX;
@@ -1132,6 +1295,7 @@ static const MSIVIEWOPS where_ops =
     NULL,
     WHERE_sort,
     NULL,
+    NULL,
 };
 
 static UINT WHERE_VerifyCondition( MSIWHEREVIEW *wv, struct expr *cond,
@@ -170,8 +170,8 @@ struct SchedulerVtbl {
     unsigned int (__thiscall *Release)(Scheduler*);
     void (__thiscall *RegisterShutdownEvent)(Scheduler*,HANDLE);
     void (__thiscall *Attach)(Scheduler*);
-    /* CreateScheduleGroup */
-    /* ScheduleTask */
+    void* (__thiscall *CreateScheduleGroup)(Scheduler*);
+    void (__thiscall *ScheduleTask)(Scheduler*,void (__cdecl*)(void*),void*);
 };
 
 static int* (__cdecl *p_errno)(void);
@@ -962,6 +962,21 @@ static void test_ExternalContextBase(void)
     CloseHandle(thread);
 }
 
+static event scheduled_evt;
+static size_t scheduled_wait_ret;
+static HANDLE scheduled_done;
+
+static void __cdecl scheduled_wait_task(void *arg)
+{
+    scheduled_wait_ret = call_func2(p_event_wait, &scheduled_evt, 5000);
+    SetEvent(scheduled_done);
+}
+
+static void __cdecl scheduled_set_task(void *arg)
+{
+    call_func1(p_event_set, &scheduled_evt);
+}
+
 static void test_Scheduler(void)
 {
     Scheduler *scheduler, *current_scheduler;
@@ -991,6 +1006,19 @@ static void test_Scheduler(void)
 
     i = call_func1(scheduler->vtable->GetNumberOfVirtualProcessors, scheduler);
     ok(i == 1, "Scheduler::GetNumberOfVirtualProcessors() = %u\n", i);
+
+    /* a blocked task must not prevent the other tasks from running */
+    call_func1(p_event_ctor, &scheduled_evt);
+    scheduled_done = CreateEventW(NULL, FALSE, FALSE, NULL);
+    scheduled_wait_ret = -2;
+    call_func3(scheduler->vtable->ScheduleTask, scheduler, scheduled_wait_task, NULL);
+    call_func3(scheduler->vtable->ScheduleTask, scheduler, scheduled_set_task, NULL);
+    i = WaitForSingleObject(scheduled_done, 10000);
+    ok(i == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", i);
+    ok(!scheduled_wait_ret, "event::wait returned %Id\n", scheduled_wait_ret);
+    CloseHandle(scheduled_done);
+    call_func1(p_event_dtor, &scheduled_evt);
+
     call_func1(scheduler->vtable->Release, scheduler);
     call_func1(p_SchedulerPolicy_dtor, &policy);
 }
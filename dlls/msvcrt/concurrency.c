@@ -155,6 +155,9 @@ typedef struct {
     HANDLE *shutdown_events;
     CRITICAL_SECTION cs;
     struct list scheduled_chores;
+    TP_POOL *pool;
+    TP_CALLBACK_ENVIRON env;
+    LONG blocked_contexts;
 } ThreadScheduler;
 extern const vtable_ptr ThreadScheduler_vtable;
 
@@ -964,19 +967,55 @@ bool __thiscall ExternalContextBase_IsSynchronouslyBlocked(const ExternalContext
     return this->blocked >= 1;
 }
 
+static void WINAPI scheduler_wake_proc(PTP_CALLBACK_INSTANCE instance, void *context)
+{
+}
+
+/* A blocked context doesn't use its virtual processor, allow the scheduler
+ * to run one more thread while it's blocked. */
+static void ThreadScheduler_set_blocked(ThreadScheduler *this, LONG incr)
+{
+    BOOL wake = FALSE;
+
+    EnterCriticalSection(&this->cs);
+    this->blocked_contexts += incr;
+    if (this->pool)
+    {
+        SetThreadpoolThreadMaximum(this->pool, this->virt_proc_no + this->blocked_contexts);
+        wake = incr > 0;
+    }
+    LeaveCriticalSection(&this->cs);
+
+    /* Raising the maximum doesn't start a worker for the tasks that are
+     * already queued, the pool only creates one when work is submitted. */
+    if (wake && !TrySubmitThreadpoolCallback(scheduler_wake_proc, NULL, &this->env))
+        ERR("failed to start a thread pool worker\n");
+}
+
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_Block, 4)
 void __thiscall ExternalContextBase_Block(ExternalContextBase *this)
 {
+    ThreadScheduler *scheduler = NULL;
     LONG blocked;
 
     TRACE("(%p)->()\n", this);
 
     blocked = InterlockedIncrement(&this->blocked);
+    if (blocked >= 1 && this->scheduler.scheduler &&
+            this->scheduler.scheduler->vtable == &ThreadScheduler_vtable)
+    {
+        scheduler = (ThreadScheduler*)this->scheduler.scheduler;
+        ThreadScheduler_set_blocked(scheduler, 1);
+    }
+
     while (blocked >= 1)
     {
         RtlWaitOnAddress(&this->blocked, &blocked, sizeof(LONG), NULL);
         blocked = this->blocked;
     }
+
+    if (scheduler)
+        ThreadScheduler_set_blocked(scheduler, -1);
 }
 
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_Yield, 4)
@@ -1407,6 +1446,9 @@ static void ThreadScheduler_dtor(ThreadScheduler *this)
         SetEvent(this->shutdown_events[i]);
     operator_delete(this->shutdown_events);
 
+    if (this->pool)
+        CloseThreadpool(this->pool);
+
     this->cs.DebugInfo->Spare[0] = 0;
     DeleteCriticalSection(&this->cs);
 
@@ -1568,7 +1610,7 @@ void __thiscall ThreadScheduler_ScheduleTask_loc(ThreadScheduler *this,
     arg->scheduler = this;
     ThreadScheduler_Reference(this);
 
-    work = CreateThreadpoolWork(schedule_task_proc, arg, NULL);
+    work = CreateThreadpoolWork(schedule_task_proc, arg, &this->env);
     if(!work) {
         scheduler_resource_allocation_error e;
 
@@ -1621,6 +1663,7 @@ Scheduler* __thiscall ThreadScheduler_vector_dtor(ThreadScheduler *this, unsigne
 static ThreadScheduler* ThreadScheduler_ctor(ThreadScheduler *this,
         const SchedulerPolicy *policy)
 {
+    unsigned int min_concurrency;
     SYSTEM_INFO si;
 
     TRACE("(%p)->()\n", this);
@@ -1642,6 +1685,19 @@ static ThreadScheduler* ThreadScheduler_ctor(ThreadScheduler *this,
     this->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": ThreadScheduler");
 
     list_init(&this->scheduled_chores);
+
+    /* Use a dedicated thread pool, so that the concurrency policies can be
+     * applied to the threads running the scheduled tasks. */
+    memset(&this->env, 0, sizeof(this->env));
+    this->env.Version = 1;
+    this->blocked_contexts = 0;
+    if ((this->pool = CreateThreadpool(NULL)))
+    {
+        min_concurrency = SchedulerPolicy_GetPolicyValue(&this->policy, MinConcurrency);
+        SetThreadpoolThreadMaximum(this->pool, this->virt_proc_no);
+        SetThreadpoolThreadMinimum(this->pool, min(min_concurrency, this->virt_proc_no));
+        this->env.Pool = this->pool;
+    }
     return this;
 }
 
@@ -2399,6 +2455,7 @@ static void CALLBACK exception_ptr_rethrow_finally(BOOL normal, void *data)
 _TaskCollectionStatus __stdcall _StructuredTaskCollection__RunAndWait(
         _StructuredTaskCollection *this, _UnrealizedChore *chore)
 {
+    ThreadScheduler *scheduler = NULL;
     ULONG_PTR exception;
     exception_ptr *ep;
     LONG count;
@@ -2415,7 +2472,7 @@ _TaskCollectionStatus __stdcall _StructuredTaskCollection__RunAndWait(
     }
 
     if (this->context) {
-        ThreadScheduler *scheduler = get_thread_scheduler_from_context(this->context);
+        scheduler = get_thread_scheduler_from_context(this->context);
         if (scheduler) {
             while (pick_and_execute_chore(scheduler)) ;
         }
@@ -2429,8 +2486,14 @@ _TaskCollectionStatus __stdcall _StructuredTaskCollection__RunAndWait(
         InterlockedAdd(&this->count, -count);
         count = InterlockedAdd(&this->finished, -count);
 
-        if (count < 0)
+        if (count < 0) {
+            /* help with the scheduled chores before blocking, the chores
+             * of this collection may not have been picked yet */
+            if (scheduler) {
+                while (this->finished < 0 && pick_and_execute_chore(scheduler)) ;
+            }
             call_Context_Block(this->event);
+        }
     }
 
     exception = (ULONG_PTR)this->exception;
@@ -1277,6 +1277,12 @@ typedef struct tagTLBContext
 	void *mapping;        /* memory mapping */
 	MSFT_SegDir * pTblDir;
 	ITypeLibImpl* pLibInfo;
+	TLBString **names;    /* name table entries sorted by offset */
+	UINT names_count;
+	TLBString **strings;  /* string table entries sorted by offset */
+	UINT strings_count;
+	TLBGuid **guids;      /* guid table entries indexed by offset */
+	UINT guids_count;
 } TLBContext;
 
 
@@ -2096,15 +2102,18 @@ static HRESULT MSFT_ReadAllGuids(TLBContext *pcx)
 static TLBGuid *MSFT_ReadGuid( int offset, TLBContext *pcx)
 {
     TLBGuid *ret;
+    UINT idx;
 
-    LIST_FOR_EACH_ENTRY(ret, &pcx->pLibInfo->guid_list, TLBGuid, entry){
-        if(ret->offset == offset){
-            TRACE_(typelib)("%s\n", debugstr_guid(&ret->guid));
-            return ret;
-        }
-    }
+    if (offset < 0 || offset % sizeof(MSFT_GuidEntry))
+        return NULL;
 
-    return NULL;
+    idx = offset / sizeof(MSFT_GuidEntry);
+    if (idx >= pcx->guids_count)
+        return NULL;
+
+    ret = pcx->guids[idx];
+    TRACE_(typelib)("%s\n", debugstr_guid(&ret->guid));
+    return ret;
 }
 
 static HREFTYPE MSFT_ReadHreftype( TLBContext *pcx, int offset )
@@ -2170,32 +2179,71 @@ static HRESULT MSFT_ReadAllNames(TLBContext *pcx)
     }
 }
 
-static TLBString *MSFT_ReadName( TLBContext *pcx, int offset)
+/* string entries are read in file order, so the index is sorted by offset */
+static TLBString *MSFT_FindString( TLBString **index, UINT count, int offset )
 {
-    TLBString *tlbstr;
+    UINT min = 0, max = count;
 
-    LIST_FOR_EACH_ENTRY(tlbstr, &pcx->pLibInfo->name_list, TLBString, entry) {
-        if (tlbstr->offset == offset) {
-            TRACE_(typelib)("%s\n", debugstr_w(tlbstr->str));
-            return tlbstr;
+    if (offset < 0)
+        return NULL;
+
+    while (min < max)
+    {
+        UINT mid = min + (max - min) / 2;
+
+        if (index[mid]->offset == offset)
+        {
+            TRACE_(typelib)("%s\n", debugstr_w(index[mid]->str));
+            return index[mid];
         }
+        if (index[mid]->offset < offset) min = mid + 1;
+        else max = mid;
     }
 
     return NULL;
 }
 
+static TLBString *MSFT_ReadName( TLBContext *pcx, int offset)
+{
+    return MSFT_FindString(pcx->names, pcx->names_count, offset);
+}
+
 static TLBString *MSFT_ReadString( TLBContext *pcx, int offset)
 {
-    TLBString *tlbstr;
+    return MSFT_FindString(pcx->strings, pcx->strings_count, offset);
+}
 
-    LIST_FOR_EACH_ENTRY(tlbstr, &pcx->pLibInfo->string_list, TLBString, entry) {
-        if (tlbstr->offset == offset) {
-            TRACE_(typelib)("%s\n", debugstr_w(tlbstr->str));
-            return tlbstr;
-        }
-    }
+static TLBString **MSFT_IndexStrings( struct list *string_list, UINT *count )
+{
+    TLBString **index, *tlbstr;
+    UINT i = 0;
 
-    return NULL;
+    *count = 0;
+    if (!(index = malloc(list_count(string_list) * sizeof(*index))))
+        return NULL;
+
+    LIST_FOR_EACH_ENTRY(tlbstr, string_list, TLBString, entry)
+        index[i++] = tlbstr;
+
+    *count = i;
+    return index;
+}
+
+static void MSFT_IndexTables( TLBContext *pcx )
+{
+    TLBGuid *guid;
+    UINT i = 0;
+
+    pcx->names = MSFT_IndexStrings(&pcx->pLibInfo->name_list, &pcx->names_count);
+    pcx->strings = MSFT_IndexStrings(&pcx->pLibInfo->string_list, &pcx->strings_count);
+
+    pcx->guids_count = 0;
+    if (!(pcx->guids = malloc(list_count(&pcx->pLibInfo->guid_list) * sizeof(*pcx->guids))))
+        return;
+
+    LIST_FOR_EACH_ENTRY(guid, &pcx->pLibInfo->guid_list, TLBGuid, entry)
+        pcx->guids[i++] = guid;
+    pcx->guids_count = i;
 }
 
 /*
@@ -3481,6 +3529,7 @@ static ITypeLib2* ITypeLib2_Constructor_MSFT(LPVOID pLib, DWORD dwTLBLength)
     MSFT_ReadAllNames(&cx);
     MSFT_ReadAllStrings(&cx);
     MSFT_ReadAllGuids(&cx);
+    MSFT_IndexTables(&cx);
 
     /* now fill our internal data */
     /* TLIBATTR fields */
@@ -3640,6 +3689,10 @@ static ITypeLib2* ITypeLib2_Constructor_MSFT(LPVOID pLib, DWORD dwTLBLength)
             TLB_fix_typeinfo_ptr_size(pTypeLibImpl->typeinfos[i]);
     }
 
+    free(cx.names);
+    free(cx.strings);
+    free(cx.guids);
+
     TRACE("(%p)\n", pTypeLibImpl);
     return &pTypeLibImpl->ITypeLib2_iface;
 }
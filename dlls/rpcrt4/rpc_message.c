@@ -1309,36 +1309,52 @@ static RPC_STATUS RPCRT4_default_receive_fragment(RpcConnection *Connection, Rpc
     goto fail;
   }
 
-  *Header = malloc(hdr_length);
-  memcpy(*Header, &common_hdr, sizeof(common_hdr));
+  if (common_hdr.frag_len < hdr_length) {
+    WARN("fragment length %d smaller than header length %ld\n", common_hdr.frag_len, hdr_length);
+    status = RPC_S_PROTOCOL_ERROR;
+    goto fail;
+  }
 
-  /* read the rest of packet header */
-  dwRead = rpcrt4_conn_read(Connection, &(*Header)->common + 1, hdr_length - sizeof(common_hdr));
-  if (dwRead != hdr_length - sizeof(common_hdr)) {
-    WARN("bad header length, %ld bytes, hdr_length %ld\n", dwRead, hdr_length);
-    status = RPC_S_CALL_FAILED;
+  *Header = malloc(hdr_length);
+  if (!*Header)
+  {
+    status = RPC_S_OUT_OF_RESOURCES;
     goto fail;
   }
+  memcpy(*Header, &common_hdr, sizeof(common_hdr));
 
-  if (common_hdr.frag_len - hdr_length)
+  if (common_hdr.frag_len == hdr_length)
   {
-    *Payload = malloc(common_hdr.frag_len - hdr_length);
+    /* read the rest of packet header */
+    dwRead = rpcrt4_conn_read(Connection, &(*Header)->common + 1, hdr_length - sizeof(common_hdr));
+    if (dwRead != hdr_length - sizeof(common_hdr)) {
+      WARN("bad header length, %ld bytes, hdr_length %ld\n", dwRead, hdr_length);
+      status = RPC_S_CALL_FAILED;
+      goto fail;
+    }
+  }
+  else
+  {
+    /* read the rest of packet header together with the payload, saving a
+     * round trip through the transport, and split them afterwards */
+    *Payload = malloc(common_hdr.frag_len - sizeof(common_hdr));
     if (!*Payload)
     {
       status = RPC_S_OUT_OF_RESOURCES;
       goto fail;
     }
 
-    dwRead = rpcrt4_conn_read(Connection, *Payload, common_hdr.frag_len - hdr_length);
-    if (dwRead != common_hdr.frag_len - hdr_length)
+    dwRead = rpcrt4_conn_read(Connection, *Payload, common_hdr.frag_len - sizeof(common_hdr));
+    if (dwRead != common_hdr.frag_len - sizeof(common_hdr))
     {
       WARN("bad data length, %ld/%ld\n", dwRead, common_hdr.frag_len - hdr_length);
       status = RPC_S_CALL_FAILED;
       goto fail;
     }
+
+    memcpy(&(*Header)->common + 1, *Payload, hdr_length - sizeof(common_hdr));
+    memmove(*Payload, (char *)*Payload + hdr_length - sizeof(common_hdr), common_hdr.frag_len - hdr_length);
   }
-  else
-    *Payload = NULL;
 
   /* success */
   status = RPC_S_OK;
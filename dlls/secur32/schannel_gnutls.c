@@ -30,6 +30,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <pthread.h>
+#include <time.h>
 #include <sys/types.h>
 #include <dlfcn.h>
 #ifdef SONAME_LIBGNUTLS
@@ -112,6 +114,9 @@ MAKE_FUNCPTR(gnutls_record_recv);
 MAKE_FUNCPTR(gnutls_record_send);
 MAKE_FUNCPTR(gnutls_server_name_set);
 MAKE_FUNCPTR(gnutls_session_channel_binding);
+MAKE_FUNCPTR(gnutls_session_get_data);
+MAKE_FUNCPTR(gnutls_session_is_resumed);
+MAKE_FUNCPTR(gnutls_session_set_data);
 MAKE_FUNCPTR(gnutls_set_default_priority);
 MAKE_FUNCPTR(gnutls_transport_get_ptr);
 MAKE_FUNCPTR(gnutls_transport_set_errno);
@@ -169,8 +174,130 @@ struct schan_transport
     gnutls_session_t session;
     struct schan_buffers in;
     struct schan_buffers out;
+    char *target;               /* set for client sessions that may be resumed */
+    UINT64 credentials;
+    DWORD enabled_protocols;
+    BOOL resumable;
+    BOOL handshake_done;
 };
 
+/* client sessions are cached per target and credentials, like Windows does */
+struct session_cache_entry
+{
+    char *target;
+    UINT64 credentials;
+    DWORD enabled_protocols;
+    void *data;
+    size_t size;
+    time_t expires;
+};
+
+#define SESSION_CACHE_SIZE      64
+#define SESSION_CACHE_LIFETIME  (10 * 60 * 60)  /* default ClientCacheTime */
+
+static struct session_cache_entry session_cache[SESSION_CACHE_SIZE];
+static unsigned int session_cache_hits, session_cache_misses;
+static pthread_mutex_t session_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void free_session_cache_entry(struct session_cache_entry *entry)
+{
+    free(entry->target);
+    free(entry->data);
+    memset(entry, 0, sizeof(*entry));
+}
+
+/* caller must hold session_cache_mutex */
+static struct session_cache_entry *find_session_cache_entry(const struct schan_transport *t)
+{
+    time_t now = time(NULL);
+    unsigned int i;
+
+    for (i = 0; i < SESSION_CACHE_SIZE; i++)
+    {
+        struct session_cache_entry *entry = &session_cache[i];
+
+        if (!entry->target) continue;
+        if (entry->expires <= now)
+        {
+            free_session_cache_entry(entry);
+            continue;
+        }
+        if (entry->credentials == t->credentials && entry->enabled_protocols == t->enabled_protocols
+                && !strcmp(entry->target, t->target))
+            return entry;
+    }
+    return NULL;
+}
+
+static void store_session(const struct schan_transport *t)
+{
+    struct session_cache_entry *entry;
+    size_t size = 0;
+    void *data;
+    int err;
+
+    err = pgnutls_session_get_data(t->session, NULL, &size);
+    if ((err != GNUTLS_E_SUCCESS && err != GNUTLS_E_SHORT_MEMORY_BUFFER) || !size) return;
+    if (!(data = malloc(size))) return;
+    if (pgnutls_session_get_data(t->session, data, &size) != GNUTLS_E_SUCCESS)
+    {
+        free(data);
+        return;
+    }
+
+    pthread_mutex_lock(&session_cache_mutex);
+    if (!(entry = find_session_cache_entry(t)))
+    {
+        unsigned int i;
+
+        /* replace a free slot or the entry stored first */
+        entry = &session_cache[0];
+        for (i = 0; i < SESSION_CACHE_SIZE && entry->target; i++)
+            if (!session_cache[i].target || session_cache[i].expires < entry->expires)
+                entry = &session_cache[i];
+        free_session_cache_entry(entry);
+
+        if (!(entry->target = strdup(t->target)))
+        {
+            pthread_mutex_unlock(&session_cache_mutex);
+            free(data);
+            return;
+        }
+        entry->credentials = t->credentials;
+        entry->enabled_protocols = t->enabled_protocols;
+    }
+    free(entry->data);
+    entry->data = data;
+    entry->size = size;
+    entry->expires = time(NULL) + SESSION_CACHE_LIFETIME;
+    pthread_mutex_unlock(&session_cache_mutex);
+}
+
+static void restore_session(const struct schan_transport *t)
+{
+    struct session_cache_entry *entry;
+    int err;
+
+    pthread_mutex_lock(&session_cache_mutex);
+    if ((entry = find_session_cache_entry(t)))
+    {
+        err = pgnutls_session_set_data(t->session, entry->data, entry->size);
+        if (err != GNUTLS_E_SUCCESS) pgnutls_perror(err);
+    }
+    pthread_mutex_unlock(&session_cache_mutex);
+}
+
+static void purge_session_cache(UINT64 credentials)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&session_cache_mutex);
+    for (i = 0; i < SESSION_CACHE_SIZE; i++)
+        if (session_cache[i].target && session_cache[i].credentials == credentials)
+            free_session_cache_entry(&session_cache[i]);
+    pthread_mutex_unlock(&session_cache_mutex);
+}
+
 static int compat_cipher_get_block_size(gnutls_cipher_algorithm_t cipher)
 {
     switch(cipher) {
@@ -521,6 +648,9 @@ static NTSTATUS schan_create_session( void *args )
         return STATUS_INTERNAL_ERROR;
     }
     transport->session = s;
+    transport->credentials = cred->credentials;
+    transport->enabled_protocols = cred->enabled_protocols;
+    transport->resumable = !(flags & (GNUTLS_SERVER | GNUTLS_DATAGRAM));
 
     if ((status = set_priority(cred, s)))
     {
@@ -552,8 +682,11 @@ static NTSTATUS schan_dispose_session( void *args )
     const struct session_params *params = args;
     gnutls_session_t s = session_from_handle(params->session);
     struct schan_transport *t = (struct schan_transport *)pgnutls_transport_get_ptr(s);
+    /* with TLS 1.3 the session ticket only arrives after the handshake, so store the session last */
+    if (t->target && t->handshake_done) store_session(t);
     pgnutls_transport_set_ptr(s, NULL);
     pgnutls_deinit(s);
+    free(t->target);
     free(t);
     return STATUS_SUCCESS;
 }
@@ -562,7 +695,9 @@ static NTSTATUS schan_set_session_target( void *args )
 {
     const struct set_session_target_params *params = args;
     gnutls_session_t s = session_from_handle(params->session);
+    struct schan_transport *t = (struct schan_transport *)pgnutls_transport_get_ptr(s);
     pgnutls_server_name_set( s, GNUTLS_NAME_DNS, params->target, strlen(params->target) );
+    if (t->resumable && !t->target && (t->target = strdup(params->target))) restore_session(t);
     return STATUS_SUCCESS;
 }
 
@@ -658,6 +793,15 @@ static NTSTATUS schan_handshake( void *args )
         if (err == GNUTLS_E_SUCCESS)
         {
             TRACE("Handshake completed\n");
+            if (t->target && !t->handshake_done)
+            {
+                pthread_mutex_lock(&session_cache_mutex);
+                if (pgnutls_session_is_resumed(s)) session_cache_hits++;
+                else session_cache_misses++;
+                TRACE("session cache: %u hits, %u misses\n", session_cache_hits, session_cache_misses);
+                pthread_mutex_unlock(&session_cache_mutex);
+            }
+            t->handshake_done = TRUE;
             status = SEC_E_OK;
         }
         else if (err == GNUTLS_E_AGAIN)
@@ -1447,6 +1591,7 @@ static NTSTATUS schan_allocate_certificate_credentials( void *args )
 static NTSTATUS schan_free_certificate_credentials( void *args )
 {
     const struct free_certificate_credentials_params *params = args;
+    purge_session_cache(params->c->credentials);
     pgnutls_certificate_free_credentials(certificate_creds_from_handle(params->c->credentials));
     return STATUS_SUCCESS;
 }
@@ -1514,6 +1659,9 @@ static NTSTATUS process_attach( void *args )
     LOAD_FUNCPTR(gnutls_record_send);
     LOAD_FUNCPTR(gnutls_server_name_set)
     LOAD_FUNCPTR(gnutls_session_channel_binding)
+    LOAD_FUNCPTR(gnutls_session_get_data)
+    LOAD_FUNCPTR(gnutls_session_is_resumed)
+    LOAD_FUNCPTR(gnutls_session_set_data)
     LOAD_FUNCPTR(gnutls_set_default_priority)
     LOAD_FUNCPTR(gnutls_transport_get_ptr)
     LOAD_FUNCPTR(gnutls_transport_set_errno)
@@ -1594,6 +1742,9 @@ fail:
 
 static NTSTATUS process_detach( void *args )
 {
+    unsigned int i;
+
+    for (i = 0; i < SESSION_CACHE_SIZE; i++) free_session_cache_entry(&session_cache[i]);
     pgnutls_global_deinit();
     dlclose(libgnutls_handle);
     libgnutls_handle = NULL;
@@ -58,6 +58,8 @@ typedef struct regexp_t {
     struct RECharSet    *classList;    /* list of [...] bitmaps */
     const WCHAR         *source;       /* locked source string, sans // */
     DWORD               source_len;
+    BOOL                has_first_char; /* matches can only start with first_char */
+    WCHAR               first_char;
     jsbytecode          program[1];    /* regular expression bytecode */
 } regexp_t;
 
@@ -60,6 +60,8 @@ static RTL_CRITICAL_SECTION vcomp_section = { &critsect_debug, -1, 0, 0, 0, 0 };
 #define VCOMP_DYNAMIC_FLAGS_GUIDED      0x03
 #define VCOMP_DYNAMIC_FLAGS_INCREMENT   0x40
 
+#define VCOMP_BARRIER_SPIN_COUNT        4000
+
 struct vcomp_thread_data
 {
     struct vcomp_team_data  *team;
@@ -97,29 +99,83 @@ struct vcomp_team_data
     va_list                 valist;
 
     /* barrier */
-    unsigned int            barrier;
-    int                     barrier_count;
+    LONG                    barrier;
+    LONG                    barrier_count;
 };
 
 struct vcomp_task_data
 {
     /* single */
-    unsigned int            single;
+    LONG                    single;
 
     /* section */
-    unsigned int            section;
+    LONG                    section;
     int                     num_sections;
-    int                     section_index;
+    LONG64                  section_state;
 
     /* dynamic */
-    unsigned int            dynamic;
+    LONG                    dynamic;
     unsigned int            dynamic_first;
     unsigned int            dynamic_last;
     unsigned int            dynamic_iterations;
     int                     dynamic_step;
     unsigned int            dynamic_chunksize;
+    LONG64                  dynamic_state;
 };
 
+/* The section and dynamic states hold the generation of the construct in the
+ * high dword and the next section index or the number of iterations already
+ * handed out in the low dword, so that both can be updated atomically. */
+static inline LONG64 vcomp_make_state(unsigned int generation, unsigned int index)
+{
+    return ((LONG64)generation << 32) | index;
+}
+
+static inline LONG64 vcomp_read_state(LONG64 volatile *state)
+{
+    return InterlockedCompareExchange64(state, 0, 0);
+}
+
+static void vcomp_publish_state(LONG64 volatile *state, unsigned int generation)
+{
+    LONG64 prev, old = vcomp_read_state(state);
+    while ((prev = InterlockedCompareExchange64(state, vcomp_make_state(generation, 0), old)) != old)
+        old = prev;
+}
+
+/* Returns TRUE if the calling thread is the first one to reach the given
+ * generation of a construct, and is responsible for initializing it. */
+static BOOL vcomp_claim_generation(LONG volatile *task_generation, unsigned int generation)
+{
+    LONG prev, old = *task_generation;
+    while ((int)(generation - old) > 0)
+    {
+        if ((prev = InterlockedCompareExchange(task_generation, generation, old)) == old)
+            return TRUE;
+        old = prev;
+    }
+    return FALSE;
+}
+
+/* Returns TRUE if no thread started initializing the construct following the
+ * given generation, i.e. the values read from the task data before the call
+ * still belong to the given generation. */
+static inline BOOL vcomp_generation_unchanged(LONG volatile *task_generation, unsigned int generation)
+{
+    MemoryBarrier();
+    return (unsigned int)ReadAcquire(task_generation) == generation;
+}
+
+/* Waits until the state of a construct is at least at the given generation,
+ * and returns it. */
+static LONG64 vcomp_wait_state(LONG64 volatile *state, unsigned int generation)
+{
+    LONG64 ret;
+    while ((int)(generation - (unsigned int)((ret = vcomp_read_state(state)) >> 32)) > 0)
+        YieldProcessor();
+    return ret;
+}
+
 extern void CDECL _vcomp_fork_call_wrapper(void *wrapper, int nargs, void **args);
 
 static void **ptr_from_va_list(va_list valist)
@@ -259,7 +315,9 @@ static struct vcomp_thread_data *vcomp_init_thread_data(void)
 
     data->task.single           = 0;
     data->task.section          = 0;
+    data->task.section_state    = 0;
     data->task.dynamic          = 0;
+    data->task.dynamic_state    = 0;
 
     thread_data = &data->thread;
     thread_data->team           = NULL;
@@ -906,26 +964,31 @@ void CDECL _vcomp_flush(void)
 void CDECL _vcomp_barrier(void)
 {
     struct vcomp_team_data *team_data = vcomp_init_thread_data()->team;
+    LONG barrier;
 
     TRACE("()\n");
 
     if (!team_data)
         return;
 
-    EnterCriticalSection(&vcomp_section);
-    if (++team_data->barrier_count >= team_data->num_threads)
+    barrier = ReadAcquire(&team_data->barrier);
+    if (InterlockedIncrement(&team_data->barrier_count) >= team_data->num_threads)
     {
-        team_data->barrier++;
         team_data->barrier_count = 0;
-        WakeAllConditionVariable(&team_data->cond);
+        InterlockedIncrement(&team_data->barrier);
+        RtlWakeAddressAll((const void *)&team_data->barrier);
     }
     else
     {
-        unsigned int barrier = team_data->barrier;
-        while (team_data->barrier == barrier)
-            SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
+        unsigned int spin = (vcomp_num_procs > 1) ? VCOMP_BARRIER_SPIN_COUNT : 0;
+
+        /* spin for a short while before going to sleep, most barriers in
+         * well balanced loops are reached by all threads at about the same time */
+        while (spin-- && ReadAcquire(&team_data->barrier) == barrier)
+            YieldProcessor();
+        while (ReadAcquire(&team_data->barrier) == barrier)
+            RtlWaitOnAddress((const void *)&team_data->barrier, &barrier, sizeof(barrier), NULL);
     }
-    LeaveCriticalSection(&vcomp_section);
 }
 
 void CDECL _vcomp_set_num_threads(int num_threads)
@@ -951,20 +1014,11 @@ int CDECL _vcomp_single_begin(int flags)
 {
     struct vcomp_thread_data *thread_data = vcomp_init_thread_data();
     struct vcomp_task_data *task_data = thread_data->task;
-    int ret = FALSE;
 
     TRACE("(%x): semi-stub\n", flags);
 
-    EnterCriticalSection(&vcomp_section);
     thread_data->single++;
-    if ((int)(thread_data->single - task_data->single) > 0)
-    {
-        task_data->single = thread_data->single;
-        ret = TRUE;
-    }
-    LeaveCriticalSection(&vcomp_section);
-
-    return ret;
+    return vcomp_claim_generation(&task_data->single, thread_data->single);
 }
 
 void CDECL _vcomp_single_end(void)
@@ -980,33 +1034,38 @@ void CDECL _vcomp_sections_init(int n)
 
     TRACE("(%d)\n", n);
 
-    EnterCriticalSection(&vcomp_section);
     thread_data->section++;
-    if ((int)(thread_data->section - task_data->section) > 0)
+    if (vcomp_claim_generation(&task_data->section, thread_data->section))
     {
-        task_data->section       = thread_data->section;
-        task_data->num_sections  = n;
-        task_data->section_index = 0;
+        task_data->num_sections = n;
+        vcomp_publish_state(&task_data->section_state, thread_data->section);
     }
-    LeaveCriticalSection(&vcomp_section);
 }
 
 int CDECL _vcomp_sections_next(void)
 {
     struct vcomp_thread_data *thread_data = vcomp_init_thread_data();
     struct vcomp_task_data *task_data = thread_data->task;
-    int i = -1;
+    LONG64 state, prev;
+    int num_sections;
 
     TRACE("()\n");
 
-    EnterCriticalSection(&vcomp_section);
-    if (thread_data->section == task_data->section &&
-        task_data->section_index != task_data->num_sections)
+    state = vcomp_wait_state(&task_data->section_state, thread_data->section);
+    while ((unsigned int)(state >> 32) == thread_data->section)
     {
-        i = task_data->section_index++;
+        /* a thread which is done with this construct may already be
+         * initializing the next one when nowait is used */
+        num_sections = task_data->num_sections;
+        if (!vcomp_generation_unchanged(&task_data->section, thread_data->section) ||
+            (int)(unsigned int)state >= num_sections)
+            break;
+
+        if ((prev = InterlockedCompareExchange64(&task_data->section_state, state + 1, state)) == state)
+            return (unsigned int)state;
+        state = prev;
     }
-    LeaveCriticalSection(&vcomp_section);
-    return i;
+    return -1;
 }
 
 void CDECL _vcomp_for_static_simple_init(unsigned int first, unsigned int last, int step,
@@ -1316,19 +1375,17 @@ void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsig
             type = VCOMP_DYNAMIC_FLAGS_GUIDED;
         }
 
-        EnterCriticalSection(&vcomp_section);
         thread_data->dynamic++;
         thread_data->dynamic_type = type;
-        if ((int)(thread_data->dynamic - task_data->dynamic) > 0)
+        if (vcomp_claim_generation(&task_data->dynamic, thread_data->dynamic))
         {
-            task_data->dynamic              = thread_data->dynamic;
             task_data->dynamic_first        = first;
             task_data->dynamic_last         = last;
             task_data->dynamic_iterations   = iterations;
             task_data->dynamic_step         = step;
             task_data->dynamic_chunksize    = chunksize;
+            vcomp_publish_state(&task_data->dynamic_state, thread_data->dynamic);
         }
-        LeaveCriticalSection(&vcomp_section);
     }
 }
 
@@ -1351,26 +1408,47 @@ int CDECL _vcomp_for_dynamic_next(unsigned int *begin, unsigned int *end)
     else if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_CHUNKED ||
              thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED)
     {
-        unsigned int iterations = 0;
-        EnterCriticalSection(&vcomp_section);
-        if (thread_data->dynamic == task_data->dynamic &&
-            task_data->dynamic_iterations != 0)
+        unsigned int first, last, chunksize, done, remaining, iterations;
+        LONG64 state, prev;
+        int step;
+
+        state = vcomp_wait_state(&task_data->dynamic_state, thread_data->dynamic);
+        while ((unsigned int)(state >> 32) == thread_data->dynamic)
         {
-            iterations = min(task_data->dynamic_iterations, task_data->dynamic_chunksize);
+            first      = task_data->dynamic_first;
+            last       = task_data->dynamic_last;
+            step       = task_data->dynamic_step;
+            chunksize  = task_data->dynamic_chunksize;
+            iterations = task_data->dynamic_iterations;
+            done       = (unsigned int)state;
+
+            /* Once all iterations have been handed out, a thread which is done
+             * with the loop may already be initializing the next one when nowait
+             * is used. The values read above are only consistent with the state
+             * if that didn't happen yet. */
+            if (!vcomp_generation_unchanged(&task_data->dynamic, thread_data->dynamic))
+                break;
+            if (!(remaining = iterations - done))
+                break;
+
+            iterations = min(remaining, chunksize);
             if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED &&
-                task_data->dynamic_iterations > num_threads * task_data->dynamic_chunksize)
+                remaining > num_threads * chunksize)
             {
-                iterations = (task_data->dynamic_iterations + num_threads - 1) / num_threads;
+                iterations = (remaining + num_threads - 1) / num_threads;
             }
-            *begin = task_data->dynamic_first;
-            *end   = task_data->dynamic_first + (iterations - 1) * task_data->dynamic_step;
-            task_data->dynamic_iterations -= iterations;
-            task_data->dynamic_first      += iterations * task_data->dynamic_step;
-            if (!task_data->dynamic_iterations)
-                *end = task_data->dynamic_last;
+
+            if ((prev = InterlockedCompareExchange64(&task_data->dynamic_state, state + iterations, state)) != state)
+            {
+                state = prev;
+                continue;
+            }
+
+            *begin = first + done * step;
+            *end   = (iterations == remaining) ? last : *begin + (iterations - 1) * step;
+            return 1;
         }
-        LeaveCriticalSection(&vcomp_section);
-        return iterations != 0;
+        return 0;
     }
 
     return 0;
@@ -1454,7 +1532,9 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
 
     task_data.single            = 0;
     task_data.section           = 0;
+    task_data.section_state     = 0;
     task_data.dynamic           = 0;
+    task_data.dynamic_state     = 0;
 
     thread_data.team            = &team_data;
     thread_data.task            = &task_data;
@@ -1614,6 +1614,25 @@ static void CDECL for_dynamic_guided_cb(unsigned int flags, LONG *a, LONG *b, LO
     }
 }
 
+static void CDECL for_dynamic_nowait_cb(LONG *a, LONG *b)
+{
+    unsigned int begin, end;
+    int i;
+
+    /* no barrier between the loops, the first threads to finish a loop
+     * initialize the next one while the others are still in it */
+    for (i = 0; i < 100; i++)
+    {
+        p_vcomp_for_dynamic_init(VCOMP_DYNAMIC_FLAGS_CHUNKED | VCOMP_DYNAMIC_FLAGS_INCREMENT, 0, 99, 1, 1);
+        while (p_vcomp_for_dynamic_next(&begin, &end))
+            InterlockedExchangeAdd(a, end - begin + 1);
+
+        p_vcomp_for_dynamic_init(VCOMP_DYNAMIC_FLAGS_CHUNKED | VCOMP_DYNAMIC_FLAGS_INCREMENT, 0, 299, 1, 1);
+        while (p_vcomp_for_dynamic_next(&begin, &end))
+            InterlockedExchangeAdd(b, end - begin + 1);
+    }
+}
+
 static void test_vcomp_for_dynamic_init(void)
 {
     static const int guided_a[] = {0, 6041, 9072, 11179};
@@ -1688,6 +1707,17 @@ static void test_vcomp_for_dynamic_init(void)
         ok(d == guided_d[0], "expected d == %d, got %ld\n", guided_d[0], d);
     }
 
+    /* test consecutive loops with different trip counts */
+    for (i = 1; i <= 4; i++)
+    {
+        pomp_set_num_threads(i);
+
+        a = b = 0;
+        p_vcomp_fork(TRUE, 2, for_dynamic_nowait_cb, &a, &b);
+        ok(a == 10000, "expected a == 10000, got %ld\n", a);
+        ok(b == 30000, "expected b == 30000, got %ld\n", b);
+    }
+
     /* test with empty flags */
     a = b = c = d = 0;
     for_dynamic_guided_cb(0, &a, &b, &c, &d);
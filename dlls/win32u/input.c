@@ -846,6 +846,9 @@ SHORT WINAPI NtUserGetAsyncKeyState( INT key )
  */
 DWORD WINAPI NtUserGetQueueStatus( UINT flags )
 {
+    struct object_lock lock = OBJECT_LOCK_INIT;
+    const queue_shm_t *queue_shm;
+    UINT status, wake_bits = 0, changed_bits = 0;
     DWORD ret;
 
     if (flags & ~(QS_ALLINPUT | QS_ALLPOSTMESSAGE | QS_SMRESULT))
@@ -856,6 +859,15 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
 
     check_for_events( flags );
 
+    while ((status = get_shared_queue( &lock, &queue_shm )) == STATUS_PENDING)
+    {
+        wake_bits = queue_shm->wake_bits;
+        changed_bits = queue_shm->changed_bits;
+    }
+
+    /* the server only needs to be called if some changed bits have to be cleared */
+    if (!status && !(changed_bits & flags)) return MAKELONG( 0, wake_bits & flags );
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = flags;
@@ -871,10 +883,18 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
  */
 DWORD get_input_state(void)
 {
+    struct object_lock lock = OBJECT_LOCK_INIT;
+    const queue_shm_t *queue_shm;
+    UINT status, wake_bits = 0;
     DWORD ret;
 
     check_for_events( QS_INPUT );
 
+    while ((status = get_shared_queue( &lock, &queue_shm )) == STATUS_PENDING)
+        wake_bits = queue_shm->wake_bits;
+
+    if (!status) return wake_bits & (QS_KEY | QS_MOUSEBUTTON);
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = 0;
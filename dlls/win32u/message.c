@@ -2643,6 +2643,34 @@ static BOOL process_hardware_message( MSG *msg, UINT hw_id, const struct hardwar
     return ret;
 }
 
+/***********************************************************************
+ *           is_queue_idle
+ *
+ * Check in the shared queue data whether a get_message request with the
+ * given filter would only return STATUS_PENDING, so that it can be skipped.
+ */
+static BOOL is_queue_idle( const struct peek_message_filter *filter )
+{
+    struct object_lock lock = OBJECT_LOCK_INIT;
+    const queue_shm_t *queue_shm;
+    BOOL idle = FALSE;
+    UINT status;
+
+    while ((status = get_shared_queue( &lock, &queue_shm )) == STATUS_PENDING)
+    {
+        /* the masks must be the ones the server would set, and the access time
+         * must be recent enough that the queue doesn't get reported as hung */
+        idle = queue_shm->wake_mask == (filter->mask & (QS_SENDMESSAGE | QS_SMRESULT)) &&
+               queue_shm->changed_mask == filter->mask &&
+               !(queue_shm->wake_bits & (QS_ALLINPUT | QS_ALLPOSTMESSAGE)) &&
+               !(queue_shm->changed_bits & (QS_ALLINPUT | QS_ALLPOSTMESSAGE)) &&
+               NtGetTickCount() - queue_shm->access_time < 3000;
+    }
+
+    if (status) return FALSE;
+    return idle;
+}
+
 /***********************************************************************
  *           peek_message
  *
@@ -2662,6 +2690,13 @@ int peek_message( MSG *msg, const struct peek_message_filter *filter )
     void *buffer;
     size_t buffer_size = 1024;
 
+    if (!filter->internal && !hwnd && is_queue_idle( filter ))
+    {
+        thread_info->wake_mask = filter->mask & (QS_SENDMESSAGE | QS_SMRESULT);
+        thread_info->changed_mask = filter->mask;
+        return 0;
+    }
+
     if (!(buffer = malloc( buffer_size ))) return -1;
 
     if (!first && !last) last = ~0;
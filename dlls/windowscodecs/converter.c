@@ -89,6 +89,139 @@ static inline float to_sRGB_component(float f)
     return 1.055f * powf(f, 1.0f/2.4f) - 0.055f;
 }
 
+static INIT_ONCE convert_tables_once = INIT_ONCE_STATIC_INIT;
+static UINT unpremultiply_factor[256];
+/* smallest linear value encoded as sRGB byte i, see linear_to_sRGB_byte() */
+static float sRGB_thresholds[256];
+
+static inline BYTE float_to_sRGB_byte(float f)
+{
+    return (BYTE)floorf(to_sRGB_component(f) * 255.0f + 0.51f);
+}
+
+static BOOL WINAPI init_convert_tables(INIT_ONCE *once, void *param, void **context)
+{
+    UINT i, lo, hi, mid;
+    float f;
+
+    /* c * 255 / alpha == (c * unpremultiply_factor[alpha]) >> 16 for all 8-bit c */
+    for (i = 1; i < 256; i++)
+        unpremultiply_factor[i] = (255 * 65536 + i - 1) / i;
+
+    /* non-negative floats are ordered like their bit patterns */
+    for (i = 1; i < 256; i++)
+    {
+        lo = 0;
+        hi = 0x3f800000; /* 1.0f */
+        while (lo < hi)
+        {
+            mid = lo + (hi - lo) / 2;
+            memcpy(&f, &mid, sizeof(f));
+            if (float_to_sRGB_byte(f) >= i) hi = mid;
+            else lo = mid + 1;
+        }
+        memcpy(&sRGB_thresholds[i], &lo, sizeof(float));
+    }
+
+    return TRUE;
+}
+
+/* Same result as float_to_sRGB_byte() for values in [0,1], without calling
+ * powf() for every pixel. Values outside of that range are clamped. */
+static inline BYTE linear_to_sRGB_byte(float f)
+{
+    UINT i = 0, step;
+
+    for (step = 128; step; step >>= 1)
+        if (f >= sRGB_thresholds[i + step]) i += step;
+
+    return i;
+}
+
+static void set_alpha_rows(BYTE *bits, UINT width, UINT height, UINT stride)
+{
+    UINT x, y;
+
+    for (y = 0; y < height; y++)
+    {
+        DWORD *pixel = (DWORD *)(bits + stride * y);
+
+        for (x = 0; x < width; x++)
+            pixel[x] |= 0xff000000;
+    }
+}
+
+static void premultiply_rows(BYTE *bits, UINT width, UINT height, UINT stride)
+{
+    UINT x, y, c;
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *pixel = bits + stride * y;
+
+        for (x = 0; x < width; x++, pixel += 4)
+        {
+            UINT alpha = pixel[3];
+
+            /* (v * alpha + 127) / 255 without the division */
+            for (c = 0; c < 3; c++)
+            {
+                UINT t = pixel[c] * alpha + 128;
+                pixel[c] = (t + (t >> 8)) >> 8;
+            }
+        }
+    }
+}
+
+static void unpremultiply_rows(BYTE *bits, UINT width, UINT height, UINT stride)
+{
+    UINT x, y;
+
+    InitOnceExecuteOnce(&convert_tables_once, init_convert_tables, NULL, NULL);
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *pixel = bits + stride * y;
+
+        for (x = 0; x < width; x++, pixel += 4)
+        {
+            BYTE alpha = pixel[3];
+
+            if (alpha != 0 && alpha != 255)
+            {
+                UINT factor = unpremultiply_factor[alpha];
+
+                pixel[0] = (pixel[0] * factor) >> 16;
+                pixel[1] = (pixel[1] * factor) >> 16;
+                pixel[2] = (pixel[2] * factor) >> 16;
+            }
+        }
+    }
+}
+
+/* Expands 24bpp rows to 32bpp with opaque alpha in place, optionally
+ * swapping the red and blue channels. */
+static void expand_24bpp_rows(BYTE *bits, UINT width, UINT height, UINT stride, BOOL swap)
+{
+    UINT x, y;
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *row = bits + stride * y;
+
+        /* walk backwards so that unread source pixels are never overwritten */
+        for (x = width; x--;)
+        {
+            BYTE c0 = row[3 * x], c1 = row[3 * x + 1], c2 = row[3 * x + 2];
+
+            row[4 * x] = swap ? c2 : c0;
+            row[4 * x + 1] = c1;
+            row[4 * x + 2] = swap ? c0 : c2;
+            row[4 * x + 3] = 0xff;
+        }
+    }
+}
+
 #if 0 /* FIXME: enable once needed */
 static inline float from_sRGB_component(float f)
 {
@@ -615,109 +748,28 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         }
         return S_OK;
     case format_24bppBGR:
-        if (prc)
-        {
-            HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcpixel;
-            BYTE *dstrow;
-            BYTE *dstpixel;
-
-            srcstride = 3 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = malloc(srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=srcrow;
-                    dstpixel=dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        *dstpixel++=*srcpixel++; /* blue */
-                        *dstpixel++=*srcpixel++; /* green */
-                        *dstpixel++=*srcpixel++; /* red */
-                        *dstpixel++=255; /* alpha */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            free(srcdata);
-
-            return res;
-        }
-        return S_OK;
     case format_24bppRGB:
         if (prc)
         {
             HRESULT res;
-            INT x, y;
-            BYTE *srcdata;
-            UINT srcstride, srcdatasize;
-            const BYTE *srcrow;
-            const BYTE *srcpixel;
-            BYTE *dstrow;
-            BYTE *dstpixel;
-            BYTE tmppixel[3];
 
-            srcstride = 3 * prc->Width;
-            srcdatasize = srcstride * prc->Height;
-
-            srcdata = malloc(srcdatasize);
-            if (!srcdata) return E_OUTOFMEMORY;
-
-            res = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
-
-            if (SUCCEEDED(res))
-            {
-                srcrow = srcdata;
-                dstrow = pbBuffer;
-                for (y=0; y<prc->Height; y++) {
-                    srcpixel=srcrow;
-                    dstpixel=dstrow;
-                    for (x=0; x<prc->Width; x++) {
-                        tmppixel[0]=*srcpixel++; /* red */
-                        tmppixel[1]=*srcpixel++; /* green */
-                        tmppixel[2]=*srcpixel++; /* blue */
-
-                        *dstpixel++=tmppixel[2]; /* blue */
-                        *dstpixel++=tmppixel[1]; /* green */
-                        *dstpixel++=tmppixel[0]; /* red */
-                        *dstpixel++=255; /* alpha */
-                    }
-                    srcrow += srcstride;
-                    dstrow += cbStride;
-                }
-            }
-
-            free(srcdata);
+            /* the destination rows are large enough to hold the source rows */
+            res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
+            if (FAILED(res)) return res;
 
-            return res;
+            expand_24bpp_rows(pbBuffer, prc->Width, prc->Height, cbStride,
+                source_format == format_24bppRGB);
         }
         return S_OK;
     case format_32bppBGR:
         if (prc)
         {
             HRESULT res;
-            INT x, y;
 
             res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(res)) return res;
 
-            /* set all alpha values to 255 */
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                    pbBuffer[cbStride*y+4*x+3] = 0xff;
+            set_alpha_rows(pbBuffer, prc->Width, prc->Height, cbStride);
         }
         return S_OK;
     case format_32bppRGBA:
@@ -737,22 +789,11 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         if (prc)
         {
             HRESULT res;
-            INT x, y;
 
             res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(res)) return res;
 
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+            unpremultiply_rows(pbBuffer, prc->Width, prc->Height, cbStride);
         }
         return S_OK;
     case format_48bppRGB:
@@ -881,15 +922,10 @@ static HRESULT copypixels_to_32bppRGBA(struct FormatConverter *This, const WICRe
     case format_32bppRGB:
         if (prc)
         {
-            INT x, y;
-
             hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(hr)) return hr;
 
-            /* set all alpha values to 255 */
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                    pbBuffer[cbStride*y+4*x+3] = 0xff;
+            set_alpha_rows(pbBuffer, prc->Width, prc->Height, cbStride);
         }
         return S_OK;
 
@@ -901,22 +937,10 @@ static HRESULT copypixels_to_32bppRGBA(struct FormatConverter *This, const WICRe
     case format_32bppPRGBA:
         if (prc)
         {
-            INT x, y;
-
             hr = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(hr)) return hr;
 
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+            unpremultiply_rows(pbBuffer, prc->Width, prc->Height, cbStride);
         }
         return S_OK;
 
@@ -974,21 +998,7 @@ static HRESULT copypixels_to_32bppPBGRA(struct FormatConverter *This, const WICR
     default:
         hr = copypixels_to_32bppBGRA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
-        {
-            INT x, y;
-
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = (pbBuffer[cbStride*y+4*x] * alpha + 127) / 255;
-                        pbBuffer[cbStride*y+4*x+1] = (pbBuffer[cbStride*y+4*x+1] * alpha + 127) / 255;
-                        pbBuffer[cbStride*y+4*x+2] = (pbBuffer[cbStride*y+4*x+2] * alpha + 127) / 255;
-                    }
-                }
-        }
+            premultiply_rows(pbBuffer, prc->Width, prc->Height, cbStride);
         return hr;
     }
 }
@@ -1007,21 +1017,7 @@ static HRESULT copypixels_to_32bppPRGBA(struct FormatConverter *This, const WICR
     default:
         hr = copypixels_to_32bppRGBA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
-        {
-            INT x, y;
-
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = (pbBuffer[cbStride*y+4*x] * alpha + 127) / 255;
-                        pbBuffer[cbStride*y+4*x+1] = (pbBuffer[cbStride*y+4*x+1] * alpha + 127) / 255;
-                        pbBuffer[cbStride*y+4*x+2] = (pbBuffer[cbStride*y+4*x+2] * alpha + 127) / 255;
-                    }
-                }
-        }
+            premultiply_rows(pbBuffer, prc->Width, prc->Height, cbStride);
         return hr;
     }
 }
@@ -1130,6 +1126,8 @@ static HRESULT copypixels_to_24bppBGR(struct FormatConverter *This, const WICRec
                 INT x, y;
                 BYTE *src = srcdata, *dst = pbBuffer;
 
+                InitOnceExecuteOnce(&convert_tables_once, init_convert_tables, NULL, NULL);
+
                 for (y = 0; y < prc->Height; y++)
                 {
                     float *gray_float = (float *)src;
@@ -1137,7 +1135,7 @@ static HRESULT copypixels_to_24bppBGR(struct FormatConverter *This, const WICRec
 
                     for (x = 0; x < prc->Width; x++)
                     {
-                        BYTE gray = (BYTE)floorf(to_sRGB_component(gray_float[x]) * 255.0f + 0.51f);
+                        BYTE gray = linear_to_sRGB_byte(gray_float[x]);
                         *bgr++ = gray;
                         *bgr++ = gray;
                         *bgr++ = gray;
@@ -1350,13 +1348,15 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
                 INT x, y;
                 BYTE *src = srcdata, *dst = pbBuffer;
 
+                InitOnceExecuteOnce(&convert_tables_once, init_convert_tables, NULL, NULL);
+
                 for (y=0; y < prc->Height; y++)
                 {
                     float *srcpixel = (float*)src;
                     BYTE *dstpixel = dst;
 
                     for (x=0; x < prc->Width; x++)
-                        *dstpixel++ = (BYTE)floorf(to_sRGB_component(*srcpixel++) * 255.0f + 0.51f);
+                        *dstpixel++ = linear_to_sRGB_byte(*srcpixel++);
 
                     src += srcstride;
                     dst += cbStride;
@@ -1384,6 +1384,8 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
         INT x, y;
         BYTE *src = srcdata, *dst = pbBuffer;
 
+        InitOnceExecuteOnce(&convert_tables_once, init_convert_tables, NULL, NULL);
+
         for (y = 0; y < prc->Height; y++)
         {
             BYTE *bgr = src;
@@ -1392,8 +1394,7 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
             {
                 float gray = (bgr[2] * 0.2126f + bgr[1] * 0.7152f + bgr[0] * 0.0722f) / 255.0f;
 
-                gray = to_sRGB_component(gray) * 255.0f;
-                dst[x] = (BYTE)floorf(gray + 0.51f);
+                dst[x] = linear_to_sRGB_byte(gray);
                 bgr += 3;
             }
             src += srcstride;
@@ -18,6 +18,7 @@
  */
 
 #include <stdarg.h>
+#include <math.h>
 
 #define COBJMACROS
 
@@ -31,6 +32,15 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(wincodecs);
 
+/* Separable resampling filter along one axis: each destination pixel is a
+ * weighted sum of "taps" consecutive source pixels starting at start[i]. */
+struct scaler_axis
+{
+    UINT taps;
+    UINT *start;
+    float *weights;
+};
+
 typedef struct BitmapScaler {
     IWICBitmapScaler IWICBitmapScaler_iface;
     LONG ref;
@@ -42,6 +52,13 @@ typedef struct BitmapScaler {
     UINT bpp;
     void (*fn_get_required_source_rect)(struct BitmapScaler*,UINT,UINT,WICRect*);
     void (*fn_copy_scanline)(struct BitmapScaler*,UINT,UINT,UINT,BYTE**,UINT,UINT,BYTE*);
+    struct scaler_axis axis_x, axis_y;
+    /* horizontally filtered source rows, kept across CopyPixels calls */
+    float *rows;
+    UINT *row_index;
+    UINT rows_x, rows_width, rows_next_y;
+    BYTE *src_line;
+    float *dst_line;
     CRITICAL_SECTION lock; /* must be held when initialized */
 } BitmapScaler;
 
@@ -55,6 +72,29 @@ static inline BitmapScaler *impl_from_IMILBitmapScaler(IMILBitmapScaler *iface)
     return CONTAINING_RECORD(iface, BitmapScaler, IMILBitmapScaler_iface);
 }
 
+static void free_scaler_axis(struct scaler_axis *axis)
+{
+    free(axis->start);
+    free(axis->weights);
+    axis->start = NULL;
+    axis->weights = NULL;
+    axis->taps = 0;
+}
+
+static void free_row_cache(BitmapScaler *This)
+{
+    free(This->rows);
+    free(This->row_index);
+    free(This->src_line);
+    free(This->dst_line);
+    This->rows = NULL;
+    This->row_index = NULL;
+    This->src_line = NULL;
+    This->dst_line = NULL;
+    This->rows_x = This->rows_width = 0;
+    This->rows_next_y = ~0u;
+}
+
 static HRESULT WINAPI BitmapScaler_QueryInterface(IWICBitmapScaler *iface, REFIID iid,
     void **ppv)
 {
@@ -106,6 +146,9 @@ static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
         This->lock.DebugInfo->Spare[0] = 0;
         DeleteCriticalSection(&This->lock);
         if (This->source) IWICBitmapSource_Release(This->source);
+        free_scaler_axis(&This->axis_x);
+        free_scaler_axis(&This->axis_y);
+        free_row_cache(This);
         free(This);
     }
 
@@ -203,6 +246,232 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+static float cubic_kernel(float x)
+{
+    /* Catmull-Rom spline, a = -0.5 */
+    x = fabsf(x);
+    if (x < 1.0f) return (1.5f * x - 2.5f) * x * x + 1.0f;
+    if (x < 2.0f) return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+    return 0.0f;
+}
+
+static float filter_weight(WICBitmapInterpolationMode mode, float dist, float scale)
+{
+    float lo, hi;
+
+    switch (mode)
+    {
+    case WICBitmapInterpolationModeLinear:
+        dist = fabsf(dist);
+        return dist < 1.0f ? 1.0f - dist : 0.0f;
+    case WICBitmapInterpolationModeCubic:
+        return cubic_kernel(dist);
+    case WICBitmapInterpolationModeHighQualityCubic:
+        /* widen the kernel when shrinking so that every source pixel contributes */
+        return cubic_kernel(dist / max(scale, 1.0f));
+    case WICBitmapInterpolationModeFant:
+    default:
+        /* area of the source pixel covered by the destination pixel */
+        lo = max(dist - 0.5f, -scale / 2.0f);
+        hi = min(dist + 0.5f, scale / 2.0f);
+        return hi > lo ? hi - lo : 0.0f;
+    }
+}
+
+static HRESULT init_scaler_axis(struct scaler_axis *axis, UINT src_size, UINT dst_size,
+    WICBitmapInterpolationMode mode)
+{
+    float scale = (float)src_size / dst_size, support, center, sum, *w;
+    UINT i, j, taps;
+    INT first;
+
+    switch (mode)
+    {
+    case WICBitmapInterpolationModeLinear:
+        support = 1.0f;
+        break;
+    case WICBitmapInterpolationModeCubic:
+        support = 2.0f;
+        break;
+    case WICBitmapInterpolationModeHighQualityCubic:
+        support = 2.0f * max(scale, 1.0f);
+        break;
+    case WICBitmapInterpolationModeFant:
+    default:
+        support = scale / 2.0f + 0.5f;
+        break;
+    }
+
+    taps = min((UINT)ceilf(support * 2.0f) + 1, src_size);
+
+    axis->taps = taps;
+    axis->start = malloc(dst_size * sizeof(*axis->start));
+    axis->weights = malloc(dst_size * taps * sizeof(*axis->weights));
+    if (!axis->start || !axis->weights)
+    {
+        free_scaler_axis(axis);
+        return E_OUTOFMEMORY;
+    }
+
+    for (i = 0; i < dst_size; i++)
+    {
+        center = (i + 0.5f) * scale - 0.5f;
+        first = (INT)floorf(center - support) + 1;
+        first = max(first, 0);
+        first = min(first, (INT)(src_size - taps));
+        axis->start[i] = first;
+
+        w = axis->weights + i * taps;
+        sum = 0.0f;
+        for (j = 0; j < taps; j++)
+        {
+            w[j] = filter_weight(mode, first + j - center, scale);
+            sum += w[j];
+        }
+
+        /* taps clipped at the image edges are redistributed over the others */
+        if (sum != 0.0f)
+            for (j = 0; j < taps; j++) w[j] /= sum;
+        else
+            w[0] = 1.0f;
+    }
+
+    return S_OK;
+}
+
+static void filter_row(const struct scaler_axis *axis, UINT dst_x, UINT dst_width,
+    UINT channels, const BYTE *src, UINT src_x, float *dst)
+{
+    UINT i, j, c, taps = axis->taps;
+
+    for (i = 0; i < dst_width; i++)
+    {
+        const BYTE *s = src + (axis->start[dst_x + i] - src_x) * channels;
+        const float *w = axis->weights + (dst_x + i) * taps;
+
+        for (c = 0; c < channels; c++)
+        {
+            float sum = 0.0f;
+
+            for (j = 0; j < taps; j++)
+                sum += w[j] * s[j * channels + c];
+            dst[i * channels + c] = sum;
+        }
+    }
+}
+
+static HRESULT Filter_CopyPixels(BitmapScaler *This, const WICRect *rc, UINT stride, BYTE *buffer)
+{
+    UINT channels = This->bpp / 8, taps_y = This->axis_y.taps;
+    UINT row_size = rc->Width * channels;
+    UINT src_x, src_width, x, y, j;
+    WICRect src_rect;
+    HRESULT hr;
+
+    src_x = This->axis_x.start[rc->X];
+    src_width = This->axis_x.start[rc->X + rc->Width - 1] + This->axis_x.taps - src_x;
+
+    /* Applications typically ask for one scanline at a time from top to
+     * bottom, so keep the horizontally filtered source rows around and only
+     * fetch the source rows that were not needed for the previous call.
+     * The source may have changed in between, so the rows are only reused
+     * when the call continues where the previous one stopped. */
+    if (!This->rows || This->rows_x != rc->X || This->rows_width != rc->Width)
+    {
+        free_row_cache(This);
+        This->rows = malloc(taps_y * row_size * sizeof(*This->rows));
+        This->row_index = malloc(taps_y * sizeof(*This->row_index));
+        This->src_line = malloc(src_width * channels);
+        This->dst_line = malloc(row_size * sizeof(*This->dst_line));
+        if (!This->rows || !This->row_index || !This->src_line || !This->dst_line)
+        {
+            free_row_cache(This);
+            return E_OUTOFMEMORY;
+        }
+        This->rows_x = rc->X;
+        This->rows_width = rc->Width;
+        This->rows_next_y = ~0u;
+    }
+    if (This->rows_next_y != rc->Y)
+    {
+        for (j = 0; j < taps_y; j++)
+            This->row_index[j] = ~0u;
+    }
+    This->rows_next_y = ~0u;
+
+    for (y = 0; y < rc->Height; y++)
+    {
+        UINT first = This->axis_y.start[rc->Y + y];
+        const float *w = This->axis_y.weights + (rc->Y + y) * taps_y;
+        float *dst_line = This->dst_line;
+        BYTE *dst = buffer + stride * y;
+
+        for (j = 0; j < taps_y; j++)
+        {
+            UINT slot = (first + j) % taps_y;
+
+            if (This->row_index[slot] == first + j) continue;
+
+            src_rect.X = src_x;
+            src_rect.Y = first + j;
+            src_rect.Width = src_width;
+            src_rect.Height = 1;
+            hr = IWICBitmapSource_CopyPixels(This->source, &src_rect, src_width * channels,
+                src_width * channels, This->src_line);
+            if (FAILED(hr))
+            {
+                This->row_index[slot] = ~0u;
+                return hr;
+            }
+
+            filter_row(&This->axis_x, rc->X, rc->Width, channels, This->src_line, src_x,
+                This->rows + slot * row_size);
+            This->row_index[slot] = first + j;
+        }
+
+        memset(dst_line, 0, row_size * sizeof(*dst_line));
+        for (j = 0; j < taps_y; j++)
+        {
+            const float *row = This->rows + ((first + j) % taps_y) * row_size;
+            float weight = w[j];
+
+            if (weight == 0.0f) continue;
+            for (x = 0; x < row_size; x++)
+                dst_line[x] += weight * row[x];
+        }
+
+        for (x = 0; x < row_size; x++)
+        {
+            float v = dst_line[x] + 0.5f;
+            dst[x] = v <= 0.0f ? 0 : v >= 255.0f ? 255 : (BYTE)v;
+        }
+    }
+
+    This->rows_next_y = rc->Y + rc->Height;
+    return S_OK;
+}
+
+static BOOL is_filter_format(const WICPixelFormatGUID *format)
+{
+    static const GUID * const formats[] =
+    {
+        &GUID_WICPixelFormat8bppGray,
+        &GUID_WICPixelFormat24bppBGR,
+        &GUID_WICPixelFormat24bppRGB,
+        &GUID_WICPixelFormat32bppBGR,
+        &GUID_WICPixelFormat32bppBGRA,
+        &GUID_WICPixelFormat32bppPBGRA,
+        &GUID_WICPixelFormat32bppRGB,
+        &GUID_WICPixelFormat32bppRGBA,
+        &GUID_WICPixelFormat32bppPRGBA,
+    };
+    UINT i;
+
+    for (i = 0; i < ARRAY_SIZE(formats); i++)
+        if (IsEqualGUID(format, formats[i])) return TRUE;
+    return FALSE;
+}
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -257,6 +526,15 @@ static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
         goto end;
     }
 
+    if (This->axis_x.weights)
+    {
+        if (dest_rect.Width && dest_rect.Height)
+            hr = Filter_CopyPixels(This, &dest_rect, cbStride, pbBuffer);
+        else
+            hr = S_OK;
+        goto end;
+    }
+
     /* MSDN recommends calling CopyPixels once for each scanline from top to
      * bottom, and claims codecs optimize for this. Ideally, when called in this
      * way, we should avoid requesting a scanline from the source more than
@@ -349,8 +627,30 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
 
     if (SUCCEEDED(hr))
     {
+        if (mode != WICBitmapInterpolationModeNearestNeighbor && !is_filter_format(&src_pixelformat))
+        {
+            FIXME("mode %i not supported for format %s, using nearest neighbor\n",
+                mode, debugstr_guid(&src_pixelformat));
+            mode = WICBitmapInterpolationModeNearestNeighbor;
+        }
+
         switch (mode)
         {
+        case WICBitmapInterpolationModeLinear:
+        case WICBitmapInterpolationModeCubic:
+        case WICBitmapInterpolationModeFant:
+        case WICBitmapInterpolationModeHighQualityCubic:
+            hr = init_scaler_axis(&This->axis_x, This->src_width, This->width, mode);
+            if (SUCCEEDED(hr))
+                hr = init_scaler_axis(&This->axis_y, This->src_height, This->height, mode);
+            if (SUCCEEDED(hr))
+            {
+                IWICBitmapSource_AddRef(pISource);
+                This->source = pISource;
+            }
+            else
+                free_scaler_axis(&This->axis_x);
+            break;
         default:
             FIXME("unsupported mode %i\n", mode);
             /* fall-through */
@@ -527,6 +827,14 @@ HRESULT BitmapScaler_Create(IWICBitmapScaler **scaler)
     This->src_height = 0;
     This->mode = 0;
     This->bpp = 0;
+    memset(&This->axis_x, 0, sizeof(This->axis_x));
+    memset(&This->axis_y, 0, sizeof(This->axis_y));
+    This->rows = NULL;
+    This->row_index = NULL;
+    This->rows_x = This->rows_width = 0;
+    This->rows_next_y = ~0u;
+    This->src_line = NULL;
+    This->dst_line = NULL;
     InitializeCriticalSectionEx(&This->lock, 0, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": BitmapScaler.lock");
 
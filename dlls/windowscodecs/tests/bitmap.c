@@ -19,6 +19,7 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <math.h>
 
@@ -1318,6 +1319,170 @@ static void test_bitmap_scaler(void)
     IWICBitmap_Release(bitmap);
 }
 
+static IWICBitmapScaler *create_gray_scaler(IWICBitmap **bitmap, const BYTE *data, UINT src_width,
+        UINT src_height, UINT width, UINT height, WICBitmapInterpolationMode mode)
+{
+    IWICBitmapScaler *scaler;
+    HRESULT hr;
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, src_width, src_height, &GUID_WICPixelFormat8bppGray,
+        src_width, src_width * src_height, (BYTE *)data, bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#lx.\n", hr);
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "Failed to create bitmap scaler, hr %#lx.\n", hr);
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)*bitmap, width, height, mode);
+    ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#lx.\n", hr);
+    return scaler;
+}
+
+static void test_bitmap_scaler_filters(void)
+{
+    static const BYTE edge[] = {0, 0, 255, 255};
+    static const BYTE edge_linear[] = {0, 0, 0, 64, 191, 255, 255, 255};
+    static const BYTE blocks[] =
+    {
+        0, 100, 200,  40,
+       20,  60,   0, 120,
+    };
+    IWICBitmapScaler *scaler;
+    IWICBitmapLock *lock;
+    IWICBitmap *bitmap;
+    BYTE buf[8], *data;
+    WICRect rc = {0, 0, 2, 1};
+    UINT i, size;
+    HRESULT hr;
+
+    /* 2x linear upscale of an edge */
+    scaler = create_gray_scaler(&bitmap, edge, 4, 1, 8, 1, WICBitmapInterpolationModeLinear);
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 8, 8, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#lx.\n", hr);
+    for (i = 0; i < ARRAY_SIZE(edge_linear); i++)
+        ok(abs(buf[i] - edge_linear[i]) <= 4, "Unexpected pixel %u: %u, expected %u.\n", i, buf[i], edge_linear[i]);
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+
+    /* Fant 2:1 downscale averages 2x2 blocks */
+    scaler = create_gray_scaler(&bitmap, blocks, 4, 2, 2, 1, WICBitmapInterpolationModeFant);
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, &rc, 2, 2, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#lx.\n", hr);
+    ok(abs(buf[0] - 45) <= 2, "Unexpected pixel 0: %u.\n", buf[0]);
+    ok(abs(buf[1] - 90) <= 2, "Unexpected pixel 1: %u.\n", buf[1]);
+
+    /* changes made to the source are picked up by the next call */
+    hr = IWICBitmap_Lock(bitmap, NULL, WICBitmapLockWrite, &lock);
+    ok(hr == S_OK, "Failed to lock the bitmap, hr %#lx.\n", hr);
+    hr = IWICBitmapLock_GetDataPointer(lock, &size, &data);
+    ok(hr == S_OK, "Failed to get the data pointer, hr %#lx.\n", hr);
+    memset(data, 0xff, size);
+    IWICBitmapLock_Release(lock);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, &rc, 2, 2, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#lx.\n", hr);
+    ok(buf[0] == 0xff && buf[1] == 0xff, "Unexpected pixels %u, %u.\n", buf[0], buf[1]);
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+}
+
+static void test_bitmap_scaler_modes(void)
+{
+    static const WICBitmapInterpolationMode modes[] =
+    {
+        WICBitmapInterpolationModeNearestNeighbor,
+        WICBitmapInterpolationModeLinear,
+        WICBitmapInterpolationModeCubic,
+        WICBitmapInterpolationModeFant,
+        WICBitmapInterpolationModeHighQualityCubic,
+    };
+    static const struct
+    {
+        UINT width, height;
+    }
+    sizes[] =
+    {
+        {16, 16},
+        {5, 3},
+        {33, 47},
+        {1, 1},
+    };
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    BYTE src[12 * 10 * 4], buf[47 * 33 * 4];
+    UINT i, j, k, y;
+    WICRect rc;
+    HRESULT hr;
+
+    for (i = 0; i < sizeof(src); i += 4)
+    {
+        src[i] = 0x10;
+        src[i + 1] = 0x80;
+        src[i + 2] = 0xf0;
+        src[i + 3] = 0xff;
+    }
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 12, 10, &GUID_WICPixelFormat32bppBGRA,
+        12 * 4, sizeof(src), src, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#lx.\n", hr);
+
+    for (i = 0; i < ARRAY_SIZE(modes); i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(sizes); j++)
+        {
+            winetest_push_context("mode %u, %ux%u", modes[i], sizes[j].width, sizes[j].height);
+
+            hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+            ok(hr == S_OK, "Failed to create bitmap scaler, hr %#lx.\n", hr);
+
+            hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap,
+                sizes[j].width, sizes[j].height, modes[i]);
+            if (hr == E_INVALIDARG && modes[i] == WICBitmapInterpolationModeHighQualityCubic)
+            {
+                win_skip("HighQualityCubic interpolation mode is not supported.\n");
+                IWICBitmapScaler_Release(scaler);
+                winetest_pop_context();
+                continue;
+            }
+            ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#lx.\n", hr);
+
+            /* whole image at once */
+            memset(buf, 0, sizeof(buf));
+            hr = IWICBitmapScaler_CopyPixels(scaler, NULL, sizes[j].width * 4, sizeof(buf), buf);
+            ok(hr == S_OK, "Failed to copy pixels, hr %#lx.\n", hr);
+            for (k = 0; k < sizes[j].width * sizes[j].height * 4; k += 4)
+            {
+                ok(buf[k] == 0x10 && buf[k + 1] == 0x80 && buf[k + 2] == 0xf0 && buf[k + 3] == 0xff,
+                    "Unexpected pixel %u: %02x%02x%02x%02x.\n", k / 4, buf[k + 3], buf[k + 2], buf[k + 1], buf[k]);
+                if (buf[k] != 0x10) break;
+            }
+
+            /* one scanline at a time */
+            for (y = 0; y < sizes[j].height; y++)
+            {
+                rc.X = 0;
+                rc.Y = y;
+                rc.Width = sizes[j].width;
+                rc.Height = 1;
+                memset(buf, 0, sizeof(buf));
+                hr = IWICBitmapScaler_CopyPixels(scaler, &rc, sizes[j].width * 4, sizeof(buf), buf);
+                ok(hr == S_OK, "Failed to copy pixels, hr %#lx.\n", hr);
+                for (k = 0; k < sizes[j].width * 4; k += 4)
+                {
+                    ok(buf[k] == 0x10 && buf[k + 1] == 0x80 && buf[k + 2] == 0xf0 && buf[k + 3] == 0xff,
+                        "Unexpected pixel %u,%u: %02x%02x%02x%02x.\n", k / 4, y, buf[k + 3], buf[k + 2], buf[k + 1], buf[k]);
+                    if (buf[k] != 0x10) break;
+                }
+            }
+
+            IWICBitmapScaler_Release(scaler);
+            winetest_pop_context();
+        }
+    }
+
+    IWICBitmap_Release(bitmap);
+}
+
 static LONG obj_refcount(void *obj)
 {
     IUnknown_AddRef((IUnknown *)obj);
@@ -1494,6 +1659,8 @@ START_TEST(bitmap)
     test_CreateBitmapFromHBITMAP();
     test_clipper();
     test_bitmap_scaler();
+    test_bitmap_scaler_modes();
+    test_bitmap_scaler_filters();
 
     IWICImagingFactory_Release(factory);
 
@@ -1973,6 +1973,33 @@ static BOOL end_of_read_data( struct request *request )
     return (request->content_length == request->content_read);
 }
 
+/* return the number of bytes that can be received straight into the caller's buffer */
+static DWORD get_direct_read_size( struct request *request, DWORD size )
+{
+    if (request->read_size || size < sizeof(request->read_buf)) return 0;
+    if (request->read_chunked)
+    {
+        if (request->read_chunked_size == ~0u || !request->read_chunked_size) return 0;
+        return min( size, request->read_chunked_size );
+    }
+    if (request->content_length == ~0u) return size;
+    return min( size, request->content_length - request->content_read );
+}
+
+/* receive body data without going through the read buffer */
+static DWORD read_direct( struct request *request, char *buffer, DWORD size, int *len, BOOL notify )
+{
+    DWORD ret;
+
+    if (notify) send_callback( &request->hdr, WINHTTP_CALLBACK_STATUS_RECEIVING_RESPONSE, NULL, 0 );
+
+    ret = netconn_recv( request->netconn, buffer, size, 0, len );
+
+    if (notify) send_callback( &request->hdr, WINHTTP_CALLBACK_STATUS_RESPONSE_RECEIVED, len, sizeof(*len) );
+    request->read_reply_len += *len;
+    return ret;
+}
+
 static DWORD read_data( struct request *request, void *buffer, DWORD size, DWORD *read, BOOL async )
 {
     int count, bytes_read = 0;
@@ -1985,14 +2012,28 @@ static DWORD read_data( struct request *request, void *buffer, DWORD size, DWORD
 
     while (size)
     {
-        if (!(count = get_available_data( request )))
+        if (!(count = get_available_data( request )) && (count = get_direct_read_size( request, size )))
         {
-            if ((ret = refill_buffer( request, async ))) goto done;
-            if (!(count = get_available_data( request ))) goto done;
+            /* nothing is buffered and the read is large, skip the intermediate copy */
+            if ((ret = read_direct( request, (char *)buffer + bytes_read, count, &count, async ))) goto done;
+            if (!count)
+            {
+                request->content_length = request->content_read = 0;
+                if (request->read_chunked) request->read_chunked_size = 0;
+                goto done;
+            }
+        }
+        else
+        {
+            if (!count)
+            {
+                if ((ret = refill_buffer( request, async ))) goto done;
+                if (!(count = get_available_data( request ))) goto done;
+            }
+            count = min( count, size );
+            memcpy( (char *)buffer + bytes_read, request->read_buf + request->read_pos, count );
+            remove_data( request, count );
         }
-        count = min( count, size );
-        memcpy( (char *)buffer + bytes_read, request->read_buf + request->read_pos, count );
-        remove_data( request, count );
         if (request->read_chunked) request->read_chunked_size -= count;
         size -= count;
         bytes_read += count;
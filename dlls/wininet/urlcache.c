@@ -179,6 +179,7 @@ typedef struct
     char *cache_prefix; /* string that has to be prefixed for this container to be used */
     LPWSTR path; /* path to url container directory */
     HANDLE mapping; /* handle of file mapping */
+    urlcache_header *header; /* view of the mapping, kept until the mapping is closed */
     DWORD file_size; /* size of file when mapping was opened */
     HANDLE mutex; /* handle of mutex */
     DWORD default_entry_type;
@@ -667,6 +668,11 @@ static DWORD cache_container_open_index(cache_container *container, DWORD blocks
  */
 static void cache_container_close_index(cache_container *pContainer)
 {
+    if (pContainer->header)
+    {
+        UnmapViewOfFile(pContainer->header);
+        pContainer->header = NULL;
+    }
     CloseHandle(pContainer->mapping);
     pContainer->mapping = NULL;
 }
@@ -683,6 +689,7 @@ static BOOL cache_containers_add(const char *cache_prefix, LPCWSTR path,
     }
 
     pContainer->mapping = NULL;
+    pContainer->header = NULL;
     pContainer->file_size = 0;
     pContainer->default_entry_type = default_entry_type;
 
@@ -878,29 +885,30 @@ static BOOL cache_containers_enum(char *search_pattern, DWORD index, cache_conta
 static urlcache_header* cache_container_lock_index(cache_container *pContainer)
 {
     BYTE index;
-    LPVOID pIndexData;
     urlcache_header* pHeader;
     DWORD error;
 
     /* acquire mutex */
     WaitForSingleObject(pContainer->mutex, INFINITE);
 
-    pIndexData = MapViewOfFile(pContainer->mapping, FILE_MAP_WRITE, 0, 0, 0);
+    /* the view is kept mapped between calls, so that every lookup
+     * doesn't have to map the whole file and fault its pages in again */
+    if (!pContainer->header)
+        pContainer->header = MapViewOfFile(pContainer->mapping, FILE_MAP_WRITE, 0, 0, 0);
+    pHeader = pContainer->header;
 
-    if (!pIndexData)
+    if (!pHeader)
     {
         ReleaseMutex(pContainer->mutex);
         ERR("Couldn't MapViewOfFile. Error: %ld\n", GetLastError());
         return NULL;
     }
-    pHeader = (urlcache_header*)pIndexData;
 
     /* file has grown - we need to remap to prevent us getting
      * access violations when we try and access beyond the end
      * of the memory mapped file */
     if (pHeader->size != pContainer->file_size)
     {
-        UnmapViewOfFile( pHeader );
         cache_container_close_index(pContainer);
         error = cache_container_open_index(pContainer, MIN_BLOCK_NO);
         if (error != ERROR_SUCCESS)
@@ -909,15 +917,15 @@ static urlcache_header* cache_container_lock_index(cache_container *pContainer)
             SetLastError(error);
             return NULL;
         }
-        pIndexData = MapViewOfFile(pContainer->mapping, FILE_MAP_WRITE, 0, 0, 0);
+        pContainer->header = MapViewOfFile(pContainer->mapping, FILE_MAP_WRITE, 0, 0, 0);
+        pHeader = pContainer->header;
 
-        if (!pIndexData)
+        if (!pHeader)
         {
             ReleaseMutex(pContainer->mutex);
             ERR("Couldn't MapViewOfFile. Error: %ld\n", GetLastError());
             return NULL;
         }
-        pHeader = (urlcache_header*)pIndexData;
     }
 
     TRACE("Signature: %s, file size: %ld bytes\n", pHeader->signature, pHeader->size);
@@ -936,9 +944,13 @@ static urlcache_header* cache_container_lock_index(cache_container *pContainer)
  */
 static BOOL cache_container_unlock_index(cache_container *pContainer, urlcache_header *pHeader)
 {
+    /* the container's view stays mapped until cache_container_close_index,
+     * only a view left over from a failed cache_container_clean_index is unmapped */
+    if (pHeader && pHeader != pContainer->header)
+        UnmapViewOfFile(pHeader);
+
     /* release mutex */
-    ReleaseMutex(pContainer->mutex);
-    return UnmapViewOfFile(pHeader);
+    return ReleaseMutex(pContainer->mutex);
 }
 
 /***********************************************************************
@@ -1167,16 +1179,18 @@ static DWORD cache_container_clean_index(cache_container *container, urlcache_he
         return ERROR_NOT_ENOUGH_MEMORY;
     }
 
+    /* keep the old view mapped, the caller still uses it if we fail */
+    container->header = NULL;
     cache_container_close_index(container);
     ret = cache_container_open_index(container, header->capacity_in_blocks*2);
     if(ret != ERROR_SUCCESS)
         return ret;
-    header = MapViewOfFile(container->mapping, FILE_MAP_WRITE, 0, 0, 0);
-    if(!header)
+    container->header = MapViewOfFile(container->mapping, FILE_MAP_WRITE, 0, 0, 0);
+    if(!container->header)
         return GetLastError();
 
     UnmapViewOfFile(*file_view);
-    *file_view = header;
+    *file_view = container->header;
     return ERROR_SUCCESS;
 }
 
@@ -1477,6 +1491,9 @@ static inline entry_hash_table* urlcache_get_hash_table(const urlcache_header *p
     return (entry_hash_table*)((LPBYTE)pHeader + dwOffset);
 }
 
+/* lookup statistics */
+static LONG hash_lookup_hits, hash_lookup_misses;
+
 static BOOL urlcache_find_hash_entry(const urlcache_header *pHeader, LPCSTR lpszUrl, struct hash_entry **ppHashEntry)
 {
     /* structure of hash table:
@@ -1495,6 +1512,7 @@ static BOOL urlcache_find_hash_entry(const urlcache_header *pHeader, LPCSTR lpsz
     DWORD offset = (key & (HASHTABLE_NUM_ENTRIES-1)) * HASHTABLE_BLOCKSIZE;
     entry_hash_table* pHashEntry;
     DWORD id = 0;
+    LONG misses;
 
     key >>= HASHTABLE_FLAG_BITS;
 
@@ -1525,11 +1543,16 @@ static BOOL urlcache_find_hash_entry(const urlcache_header *pHeader, LPCSTR lpsz
                  * and the URL stored in the entry. However, this assumes
                  * we know the format of all the entries stored in the
                  * hash table */
+                LONG hits = InterlockedIncrement(&hash_lookup_hits);
+
                 *ppHashEntry = pHashElement;
+                TRACE("%s found in table %ld, %ld hits\n", debugstr_a(lpszUrl), id - 1, hits);
                 return TRUE;
             }
         }
     }
+    misses = InterlockedIncrement(&hash_lookup_misses);
+    TRACE("%s not found in %ld tables, %ld misses\n", debugstr_a(lpszUrl), id, misses);
     return FALSE;
 }
 
@@ -3807,7 +3830,10 @@ BOOL WINAPI GetUrlCacheConfigInfoW(LPINTERNET_CACHE_CONFIG_INFOW info, LPDWORD s
     info->dwCacheSize = container->file_size / 1024;
     lstrcpynW(info->CachePath, container->path, MAX_PATH);
 
+    /* another thread may be using the mapped view */
+    WaitForSingleObject(container->mutex, INFINITE);
     cache_container_close_index(container);
+    ReleaseMutex(container->mutex);
 
     TRACE("CachePath %s\n", debugstr_w(info->CachePath));
 
@@ -900,6 +900,11 @@ typedef volatile struct
 typedef volatile struct
 {
     int                  hooks_count[WH_MAX - WH_MIN + 2];
+    unsigned int         wake_bits;
+    unsigned int         wake_mask;
+    unsigned int         changed_bits;
+    unsigned int         changed_mask;
+    unsigned int         access_time;
 } queue_shm_t;
 
 typedef volatile union
@@ -6587,7 +6592,7 @@ union generic_reply
 
 /* ### protocol_version begin ### */
 
-#define SERVER_PROTOCOL_VERSION 819
+#define SERVER_PROTOCOL_VERSION 820
 
 /* ### protocol_version end ### */
 
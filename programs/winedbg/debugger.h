@@ -423,6 +423,9 @@ extern void             print_bare_address(const ADDRESS64* addr);
 extern void             print_address(const ADDRESS64* addr, BOOLEAN with_line);
 extern void             print_basic(const struct dbg_lvalue* value, char format);
 
+  /* profile.c */
+extern enum dbg_start   dbg_profile(int argc, char* argv[]);
+
   /* source.c */
 extern void             source_list(IMAGEHLP_LINE64* src1, IMAGEHLP_LINE64* src2, int delta);
 extern void             source_list_from_addr(const ADDRESS64* addr, int nlines);
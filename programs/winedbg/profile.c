@@ -0,0 +1,464 @@
+/*
+ * Wine debugger - sampling profiler
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/*
+ * The profiler doesn't debug the target process: it periodically suspends
+ * each of its threads, walks the stack with dbghelp and resumes it. Stacks
+ * are only stored as raw addresses while sampling; symbols are resolved once
+ * per address when the capture is over, and the result is written in the
+ * "folded" format (one line per distinct stack, outermost frame first,
+ * followed by the number of samples), as used by flame graph tools.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "debugger.h"
+#include "tlhelp32.h"
+#include "wine/debug.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(winedbg);
+
+#define PROFILE_MAX_FRAMES      128
+#define PROFILE_HASH_SIZE       4096
+#define PROFILE_REFRESH_TICKS   1000    /* how often threads and modules are rescanned */
+
+struct profile_stack
+{
+    struct profile_stack*       next;
+    unsigned                    hash;
+    unsigned                    count;
+    unsigned                    depth;
+    DWORD64                     frames[1];
+};
+
+struct profile_symbol
+{
+    struct profile_symbol*      next;
+    DWORD64                     addr;
+    char                        name[1];
+};
+
+struct profile_thread
+{
+    DWORD                       tid;
+    HANDLE                      handle;
+};
+
+struct profiler
+{
+    HANDLE                      process;
+    DWORD                       pid;
+    DWORD                       machine;
+    struct profile_thread*      threads;
+    unsigned                    num_threads;
+    unsigned                    num_samples;
+    unsigned                    num_failed;
+    struct profile_stack*       stacks[PROFILE_HASH_SIZE];
+    struct profile_symbol*      symbols[PROFILE_HASH_SIZE];
+};
+
+static unsigned profile_hash(const DWORD64* frames, unsigned depth)
+{
+    unsigned hash = depth;
+
+    while (depth--)
+        hash = hash * 31 + (unsigned)(frames[depth] ^ (frames[depth] >> 32));
+    return hash;
+}
+
+static void profile_free_threads(struct profiler* prof)
+{
+    unsigned i;
+
+    for (i = 0; i < prof->num_threads; i++) CloseHandle(prof->threads[i].handle);
+    free(prof->threads);
+    prof->threads = NULL;
+    prof->num_threads = 0;
+}
+
+/* (re)open all the threads of the target process */
+static void profile_scan_threads(struct profiler* prof)
+{
+    THREADENTRY32 entry;
+    unsigned size = 0;
+    HANDLE snap, handle;
+
+    profile_free_threads(prof);
+
+    snap = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+    if (snap == INVALID_HANDLE_VALUE) return;
+
+    entry.dwSize = sizeof(entry);
+    if (Thread32First(snap, &entry))
+    {
+        do
+        {
+            if (entry.th32OwnerProcessID != prof->pid) continue;
+            handle = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION,
+                                FALSE, entry.th32ThreadID);
+            if (!handle) continue;
+            if (prof->num_threads == size)
+            {
+                struct profile_thread* new;
+
+                size = size ? size * 2 : 16;
+                if (!(new = realloc(prof->threads, size * sizeof(*new))))
+                {
+                    CloseHandle(handle);
+                    break;
+                }
+                prof->threads = new;
+            }
+            prof->threads[prof->num_threads].tid = entry.th32ThreadID;
+            prof->threads[prof->num_threads].handle = handle;
+            prof->num_threads++;
+        } while (Thread32Next(snap, &entry));
+    }
+    CloseHandle(snap);
+}
+
+static void profile_add_stack(struct profiler* prof, const DWORD64* frames, unsigned depth)
+{
+    unsigned hash = profile_hash(frames, depth);
+    struct profile_stack* stack;
+
+    for (stack = prof->stacks[hash % PROFILE_HASH_SIZE]; stack; stack = stack->next)
+    {
+        if (stack->hash == hash && stack->depth == depth &&
+            !memcmp(stack->frames, frames, depth * sizeof(frames[0])))
+        {
+            stack->count++;
+            return;
+        }
+    }
+
+    if (!(stack = malloc(offsetof(struct profile_stack, frames[depth])))) return;
+    stack->hash = hash;
+    stack->count = 1;
+    stack->depth = depth;
+    memcpy(stack->frames, frames, depth * sizeof(frames[0]));
+    stack->next = prof->stacks[hash % PROFILE_HASH_SIZE];
+    prof->stacks[hash % PROFILE_HASH_SIZE] = stack;
+}
+
+union profile_context
+{
+    CONTEXT                     native;
+#ifdef __x86_64__
+    WOW64_CONTEXT               wow64;
+#endif
+};
+
+/* fetches the context of a suspended thread, and sets up the first frame from it */
+static BOOL profile_get_context(struct profiler* prof, HANDLE thread, union profile_context* ctx,
+                                STACKFRAME_EX* sf)
+{
+    memset(ctx, 0, sizeof(*ctx));
+#ifdef __x86_64__
+    if (prof->machine == IMAGE_FILE_MACHINE_I386)
+    {
+        ctx->wow64.ContextFlags = WOW64_CONTEXT_FULL;
+        if (!Wow64GetThreadContext(thread, &ctx->wow64)) return FALSE;
+        sf->AddrPC.Offset    = ctx->wow64.Eip;
+        sf->AddrFrame.Offset = ctx->wow64.Ebp;
+        sf->AddrStack.Offset = ctx->wow64.Esp;
+        return TRUE;
+    }
+#endif
+    ctx->native.ContextFlags = CONTEXT_FULL;
+    if (!GetThreadContext(thread, &ctx->native)) return FALSE;
+#if defined(__i386__)
+    sf->AddrPC.Offset    = ctx->native.Eip;
+    sf->AddrFrame.Offset = ctx->native.Ebp;
+    sf->AddrStack.Offset = ctx->native.Esp;
+#elif defined(__x86_64__)
+    sf->AddrPC.Offset    = ctx->native.Rip;
+    sf->AddrFrame.Offset = ctx->native.Rbp;
+    sf->AddrStack.Offset = ctx->native.Rsp;
+#elif defined(__aarch64__)
+    sf->AddrPC.Offset    = ctx->native.Pc;
+    sf->AddrFrame.Offset = ctx->native.Fp;
+    sf->AddrStack.Offset = ctx->native.Sp;
+#elif defined(__arm__)
+    sf->AddrPC.Offset    = ctx->native.Pc;
+    sf->AddrFrame.Offset = ctx->native.R11;
+    sf->AddrStack.Offset = ctx->native.Sp;
+#endif
+    return TRUE;
+}
+
+static BOOL profile_sample_thread(struct profiler* prof, HANDLE thread)
+{
+    DWORD64 frames[PROFILE_MAX_FRAMES];
+    STACKFRAME_EX sf;
+    unsigned depth = 0;
+    union profile_context ctx;
+
+    if (SuspendThread(thread) == (DWORD)-1) return FALSE;
+
+    memset(&sf, 0, sizeof(sf));
+    sf.StackFrameSize = sizeof(sf);
+    sf.InlineFrameContext = INLINE_FRAME_CONTEXT_IGNORE;
+    sf.AddrPC.Mode = sf.AddrFrame.Mode = sf.AddrStack.Mode = AddrModeFlat;
+    if (!profile_get_context(prof, thread, &ctx, &sf))
+    {
+        ResumeThread(thread);
+        return FALSE;
+    }
+
+    while (depth < PROFILE_MAX_FRAMES &&
+           StackWalkEx(prof->machine, prof->process, thread, &sf, &ctx, NULL,
+                       SymFunctionTableAccess64, SymGetModuleBase64, NULL, SYM_STKWALK_DEFAULT))
+    {
+        if (!sf.AddrPC.Offset) break;
+        /* point return addresses inside the call instruction */
+        frames[depth] = depth ? sf.AddrPC.Offset - 1 : sf.AddrPC.Offset;
+        depth++;
+    }
+    ResumeThread(thread);
+
+    if (!depth) return FALSE;
+    profile_add_stack(prof, frames, depth);
+    return TRUE;
+}
+
+static const char* profile_get_symbol(struct profiler* prof, DWORD64 addr)
+{
+    char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+    SYMBOL_INFO* si = (SYMBOL_INFO*)buffer;
+    IMAGEHLP_MODULE64 im;
+    struct profile_symbol* sym;
+    char name[MAX_SYM_NAME + 64];
+    const char* module = NULL;
+    DWORD64 disp;
+    unsigned hash = (unsigned)(addr ^ (addr >> 32)) % PROFILE_HASH_SIZE;
+    size_t len;
+
+    for (sym = prof->symbols[hash]; sym; sym = sym->next)
+        if (sym->addr == addr) return sym->name;
+
+    im.SizeOfStruct = sizeof(im);
+    if (SymGetModuleInfo64(prof->process, addr, &im)) module = im.ModuleName;
+
+    si->SizeOfStruct = sizeof(*si);
+    si->MaxNameLen = MAX_SYM_NAME;
+    if (SymFromAddr(prof->process, addr, &disp, si))
+        snprintf(name, sizeof(name), "%s!%s", module ? module : "?", si->Name);
+    else if (module)
+        snprintf(name, sizeof(name), "%s!0x%I64x", module, addr - im.BaseOfImage);
+    else
+        snprintf(name, sizeof(name), "0x%I64x", addr);
+
+    len = strlen(name);
+    if (!(sym = malloc(offsetof(struct profile_symbol, name[len + 1])))) return "?";
+    sym->addr = addr;
+    memcpy(sym->name, name, len + 1);
+    sym->next = prof->symbols[hash];
+    prof->symbols[hash] = sym;
+    return sym->name;
+}
+
+static void profile_dump(struct profiler* prof)
+{
+    struct profile_stack* stack;
+    unsigned i, j;
+
+    /* pick up the modules loaded since the last scan */
+    SymRefreshModuleList(prof->process);
+
+    for (i = 0; i < PROFILE_HASH_SIZE; i++)
+    {
+        for (stack = prof->stacks[i]; stack; stack = stack->next)
+        {
+            for (j = stack->depth; j > 0; j--)
+                dbg_printf("%s%s", profile_get_symbol(prof, stack->frames[j - 1]), j > 1 ? ";" : "");
+            dbg_printf(" %u\n", stack->count);
+        }
+    }
+}
+
+static void profile_cleanup(struct profiler* prof)
+{
+    struct profile_stack* stack;
+    struct profile_symbol* sym;
+    unsigned i;
+
+    profile_free_threads(prof);
+    for (i = 0; i < PROFILE_HASH_SIZE; i++)
+    {
+        while ((stack = prof->stacks[i]))
+        {
+            prof->stacks[i] = stack->next;
+            free(stack);
+        }
+        while ((sym = prof->symbols[i]))
+        {
+            prof->symbols[i] = sym->next;
+            free(sym);
+        }
+    }
+}
+
+static BOOL profile_get_machine(HANDLE process, DWORD* machine)
+{
+    USHORT process_machine, native_machine;
+
+    if (!IsWow64Process2(process, &process_machine, &native_machine)) return FALSE;
+    if (process_machine == IMAGE_FILE_MACHINE_UNKNOWN) process_machine = native_machine;
+#if defined(__i386__)
+    *machine = IMAGE_FILE_MACHINE_I386;
+#elif defined(__x86_64__)
+    *machine = IMAGE_FILE_MACHINE_AMD64;
+#elif defined(__aarch64__)
+    *machine = IMAGE_FILE_MACHINE_ARM64;
+#elif defined(__arm__)
+    *machine = IMAGE_FILE_MACHINE_ARMNT;
+#else
+    return FALSE;
+#endif
+#ifdef __x86_64__
+    /* 32-bit threads of WoW64 processes are sampled with Wow64GetThreadContext */
+    if (process_machine == IMAGE_FILE_MACHINE_I386)
+    {
+        *machine = IMAGE_FILE_MACHINE_I386;
+        return TRUE;
+    }
+#endif
+    /* otherwise the sampled contexts are native ones */
+    return process_machine == *machine;
+}
+
+/******************************************************************
+ *		dbg_profile
+ *
+ * Samples the stacks of a running process:
+ *      --profile [--interval <ms>] [--duration <s>] [--output <file>] <pid>
+ */
+enum dbg_start dbg_profile(int argc, char* argv[])
+{
+    struct profiler* prof;
+    DWORD interval = 10, duration = 10, start, last_refresh, now;
+    const char* output = NULL;
+    HANDLE file = INVALID_HANDLE_VALUE;
+    char* end;
+    unsigned i;
+
+    argc--; argv++;
+    while (argc > 1 && argv[0][0] == '-')
+    {
+        if (!strcmp(argv[0], "--interval"))
+        {
+            interval = strtoul(argv[1], &end, 0);
+            if (*end || !interval) return start_error_parse;
+        }
+        else if (!strcmp(argv[0], "--duration"))
+        {
+            duration = strtoul(argv[1], &end, 0);
+            if (*end) return start_error_parse;
+        }
+        else if (!strcmp(argv[0], "--output"))
+            output = argv[1];
+        else return start_error_parse;
+        argc -= 2; argv += 2;
+    }
+    if (argc != 1) return start_error_parse;
+
+    if (!(prof = calloc(1, sizeof(*prof)))) return start_error_init;
+    prof->pid = strtoul(argv[0], &end, 0);
+    if (*end || !prof->pid)
+    {
+        free(prof);
+        return start_error_parse;
+    }
+
+    prof->process = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ | SYNCHRONIZE, FALSE, prof->pid);
+    if (!prof->process)
+    {
+        dbg_printf("Couldn't open process %04lx (%lu)\n", prof->pid, GetLastError());
+        free(prof);
+        return start_error_init;
+    }
+    if (!profile_get_machine(prof->process, &prof->machine))
+    {
+        dbg_printf("Process %04lx has an unsupported architecture\n", prof->pid);
+        CloseHandle(prof->process);
+        free(prof);
+        return start_error_init;
+    }
+    if (!dbg_init(prof->process, NULL, TRUE))
+    {
+        dbg_printf("Couldn't initialize symbols for process %04lx\n", prof->pid);
+        CloseHandle(prof->process);
+        free(prof);
+        return start_error_init;
+    }
+
+    if (output)
+    {
+        file = CreateFileA(output, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            dbg_printf("Couldn't create %s (%lu)\n", output, GetLastError());
+            SymCleanup(prof->process);
+            CloseHandle(prof->process);
+            free(prof);
+            return start_error_init;
+        }
+    }
+
+    profile_scan_threads(prof);
+    start = last_refresh = GetTickCount();
+
+    /* the wait doubles as the sampling timer, and stops when the process exits */
+    while (WaitForSingleObject(prof->process, interval) == WAIT_TIMEOUT)
+    {
+        now = GetTickCount();
+        if (duration && now - start >= duration * 1000) break;
+        if (now - last_refresh >= PROFILE_REFRESH_TICKS)
+        {
+            profile_scan_threads(prof);
+            SymRefreshModuleList(prof->process);
+            last_refresh = now;
+        }
+        for (i = 0; i < prof->num_threads; i++)
+        {
+            if (profile_sample_thread(prof, prof->threads[i].handle)) prof->num_samples++;
+            else prof->num_failed++;
+        }
+    }
+
+    WINE_TRACE("%u samples (%u failed) in %lu ms\n", prof->num_samples, prof->num_failed, GetTickCount() - start);
+
+    if (file != INVALID_HANDLE_VALUE) dbg_houtput = file;
+    profile_dump(prof);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        dbg_houtput = GetStdHandle(STD_OUTPUT_HANDLE);
+        CloseHandle(file);
+    }
+
+    profile_cleanup(prof);
+    SymCleanup(prof->process);
+    CloseHandle(prof->process);
+    free(prof);
+    return start_ok;
+}
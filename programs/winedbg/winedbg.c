@@ -625,6 +625,9 @@ static int dbg_winedbg_usage(BOOL advanced)
                "                           gdb (proxied) on it\n"
                "   winedbg <file.mdmp>     reload the minidump <file.mdmp> into memory and run\n"
                "                           WineDbg on it\n"
+               "   winedbg --profile [--interval <ms>] [--duration <s>] [--output <file>] <num>\n"
+               "                           sample the stacks of running process of wpid <num>\n"
+               "                           and print them in folded format\n"
                "   winedbg --help          prints advanced options\n");
     }
     else
@@ -741,6 +744,16 @@ int main(int argc, char** argv)
         case start_error_init:  return -1;
         }
     }
+    if (argc && !strcmp(argv[0], "--profile"))
+    {
+        restart_if_wow64();
+        switch (dbg_profile(argc, argv))
+        {
+        case start_ok:          return 0;
+        case start_error_parse: return dbg_winedbg_usage(FALSE);
+        case start_error_init:  return -1;
+        }
+    }
     /* parse options */
     while (argc > 0 && argv[0][0] == '-')
     {
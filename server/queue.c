@@ -125,10 +125,6 @@ struct msg_queue
 {
     struct object          obj;             /* object header */
     struct fd             *fd;              /* optional file descriptor to poll */
-    unsigned int           wake_bits;       /* wakeup bits */
-    unsigned int           wake_mask;       /* wakeup mask */
-    unsigned int           changed_bits;    /* changed wakeup bits */
-    unsigned int           changed_mask;    /* changed wakeup mask */
     int                    paint_count;     /* pending paint messages count */
     int                    hotkey_count;    /* pending hotkey messages count */
     int                    quit_message;    /* is there a pending quit message? */
@@ -144,7 +140,6 @@ struct msg_queue
     struct timeout_user   *timeout;         /* timeout for next timer to expire */
     struct thread_input   *input;           /* thread input descriptor */
     struct hook_table     *hooks;           /* hook table */
-    timeout_t              last_get_msg;    /* time of last get message call */
     int                    keystate_lock;   /* owns an input keystate lock */
     const queue_shm_t     *shared;          /* queue in session shared memory */
 };
@@ -302,10 +297,6 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
     if ((queue = alloc_object( &msg_queue_ops )))
     {
         queue->fd              = NULL;
-        queue->wake_bits       = 0;
-        queue->wake_mask       = 0;
-        queue->changed_bits    = 0;
-        queue->changed_mask    = 0;
         queue->paint_count     = 0;
         queue->hotkey_count    = 0;
         queue->quit_message    = 0;
@@ -315,7 +306,6 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
         queue->timeout         = NULL;
         queue->input           = (struct thread_input *)grab_object( input );
         queue->hooks           = NULL;
-        queue->last_get_msg    = current_time;
         queue->keystate_lock   = 0;
         list_init( &queue->send_result );
         list_init( &queue->callback_result );
@@ -332,6 +322,11 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
         SHARED_WRITE_BEGIN( queue->shared, queue_shm_t )
         {
             memset( (void *)shared->hooks_count, 0, sizeof(shared->hooks_count) );
+            shared->wake_bits    = 0;
+            shared->wake_mask    = 0;
+            shared->changed_bits = 0;
+            shared->changed_mask = 0;
+            shared->access_time  = get_tick_count();
         }
         SHARED_WRITE_END;
 
@@ -642,7 +637,32 @@ void add_queue_hook_count( struct thread *thread, unsigned int index, int count
 /* check the queue status */
 static inline int is_signaled( struct msg_queue *queue )
 {
-    return ((queue->wake_bits & queue->wake_mask) || (queue->changed_bits & queue->changed_mask));
+    const queue_shm_t *queue_shm = queue->shared;
+    return ((queue_shm->wake_bits & queue_shm->wake_mask) ||
+            (queue_shm->changed_bits & queue_shm->changed_mask));
+}
+
+/* set the queue wakeup masks */
+static void set_queue_masks( struct msg_queue *queue, unsigned int wake_mask, unsigned int changed_mask )
+{
+    SHARED_WRITE_BEGIN( queue->shared, queue_shm_t )
+    {
+        shared->wake_mask = wake_mask;
+        shared->changed_mask = changed_mask;
+    }
+    SHARED_WRITE_END;
+}
+
+/* clear some of the changed bits, without changing the wake bits */
+static void clear_changed_bits( struct msg_queue *queue, unsigned int bits )
+{
+    if (!(queue->shared->changed_bits & bits)) return;
+
+    SHARED_WRITE_BEGIN( queue->shared, queue_shm_t )
+    {
+        shared->changed_bits &= ~bits;
+    }
+    SHARED_WRITE_END;
 }
 
 /* set some queue bits */
@@ -653,17 +673,25 @@ static inline void set_queue_bits( struct msg_queue *queue, unsigned int bits )
         if (!queue->keystate_lock) lock_input_keystate( queue->input );
         queue->keystate_lock = 1;
     }
-    queue->wake_bits |= bits;
-    queue->changed_bits |= bits;
+    SHARED_WRITE_BEGIN( queue->shared, queue_shm_t )
+    {
+        shared->wake_bits |= bits;
+        shared->changed_bits |= bits;
+    }
+    SHARED_WRITE_END;
     if (is_signaled( queue )) wake_up( &queue->obj, 0 );
 }
 
 /* clear some queue bits */
 static inline void clear_queue_bits( struct msg_queue *queue, unsigned int bits )
 {
-    queue->wake_bits &= ~bits;
-    queue->changed_bits &= ~bits;
-    if (!(queue->wake_bits & (QS_KEY | QS_MOUSEBUTTON)))
+    SHARED_WRITE_BEGIN( queue->shared, queue_shm_t )
+    {
+        shared->wake_bits &= ~bits;
+        shared->changed_bits &= ~bits;
+    }
+    SHARED_WRITE_END;
+    if (!(queue->shared->wake_bits & (QS_KEY | QS_MOUSEBUTTON)))
     {
         if (queue->keystate_lock) unlock_input_keystate( queue->input );
         queue->keystate_lock = 0;
@@ -1139,7 +1167,7 @@ static int is_queue_hung( struct msg_queue *queue )
 {
     struct wait_queue_entry *entry;
 
-    if (current_time - queue->last_get_msg <= 5 * TICKS_PER_SEC)
+    if (get_tick_count() - queue->shared->access_time <= 5000)
         return 0;  /* less than 5 seconds since last get message -> not hung */
 
     LIST_FOR_EACH_ENTRY( entry, &queue->obj.wait_queue, struct wait_queue_entry, entry )
@@ -1180,7 +1208,7 @@ static void msg_queue_dump( struct object *obj, int verbose )
 {
     struct msg_queue *queue = (struct msg_queue *)obj;
     fprintf( stderr, "Msg queue bits=%x mask=%x\n",
-             queue->wake_bits, queue->wake_mask );
+             queue->shared->wake_bits, queue->shared->wake_mask );
 }
 
 static int msg_queue_signaled( struct object *obj, struct wait_queue_entry *entry )
@@ -1203,8 +1231,7 @@ static int msg_queue_signaled( struct object *obj, struct wait_queue_entry *entr
 static void msg_queue_satisfied( struct object *obj, struct wait_queue_entry *entry )
 {
     struct msg_queue *queue = (struct msg_queue *)obj;
-    queue->wake_mask = 0;
-    queue->changed_mask = 0;
+    set_queue_masks( queue, 0, 0 );
 }
 
 static void msg_queue_destroy( struct object *obj )
@@ -1313,7 +1340,7 @@ static int check_queue_input_window( struct msg_queue *queue, user_handle_t wind
 void check_thread_queue_idle( struct thread *thread )
 {
     struct msg_queue *queue = thread->queue;
-    if ((queue->wake_mask & QS_SMRESULT)) return;
+    if ((queue->shared->wake_mask & QS_SMRESULT)) return;
     if (thread->process->idle_event) set_event( thread->process->idle_event );
 }
 
@@ -2937,14 +2964,13 @@ DECL_HANDLER(set_queue_mask)
 
     if (queue)
     {
-        queue->wake_mask    = req->wake_mask;
-        queue->changed_mask = req->changed_mask;
-        reply->wake_bits    = queue->wake_bits;
-        reply->changed_bits = queue->changed_bits;
+        set_queue_masks( queue, req->wake_mask, req->changed_mask );
+        reply->wake_bits    = queue->shared->wake_bits;
+        reply->changed_bits = queue->shared->changed_bits;
         if (is_signaled( queue ))
         {
             /* if skip wait is set, do what would have been done in the subsequent wait */
-            if (req->skip_wait) queue->wake_mask = queue->changed_mask = 0;
+            if (req->skip_wait) set_queue_masks( queue, 0, 0 );
             else wake_up( &queue->obj, 0 );
         }
     }
@@ -2957,9 +2983,9 @@ DECL_HANDLER(get_queue_status)
     struct msg_queue *queue = current->queue;
     if (queue)
     {
-        reply->wake_bits    = queue->wake_bits;
-        reply->changed_bits = queue->changed_bits;
-        queue->changed_bits &= ~req->clear_bits;
+        reply->wake_bits    = queue->shared->wake_bits;
+        reply->changed_bits = queue->shared->changed_bits;
+        clear_changed_bits( queue, req->clear_bits );
     }
     else reply->wake_bits = reply->changed_bits = 0;
 }
@@ -3129,7 +3155,14 @@ DECL_HANDLER(get_message)
         return;
     }
 
-    queue->last_get_msg = current_time;
+    if (queue->shared->access_time != get_tick_count())
+    {
+        SHARED_WRITE_BEGIN( queue->shared, queue_shm_t )
+        {
+            shared->access_time = get_tick_count();
+        }
+        SHARED_WRITE_END;
+    }
     if (!filter) filter = QS_ALLINPUT;
 
     /* first check for sent messages */
@@ -3141,13 +3174,18 @@ DECL_HANDLER(get_message)
     }
 
     /* clear changed bits so we can wait on them if we don't find a message */
-    if (filter & QS_POSTMESSAGE)
     {
-        queue->changed_bits &= ~(QS_POSTMESSAGE | QS_HOTKEY | QS_TIMER);
-        if (req->get_first == 0 && req->get_last == ~0U) queue->changed_bits &= ~QS_ALLPOSTMESSAGE;
+        unsigned int clear_bits = 0;
+
+        if (filter & QS_POSTMESSAGE)
+        {
+            clear_bits |= QS_POSTMESSAGE | QS_HOTKEY | QS_TIMER;
+            if (req->get_first == 0 && req->get_last == ~0U) clear_bits |= QS_ALLPOSTMESSAGE;
+        }
+        if (filter & QS_INPUT) clear_bits |= QS_INPUT;
+        if (filter & QS_PAINT) clear_bits |= QS_PAINT;
+        clear_changed_bits( queue, clear_bits );
     }
-    if (filter & QS_INPUT) queue->changed_bits &= ~QS_INPUT;
-    if (filter & QS_PAINT) queue->changed_bits &= ~QS_PAINT;
 
     /* then check for posted messages */
     if ((filter & QS_POSTMESSAGE) &&
@@ -3200,8 +3238,7 @@ DECL_HANDLER(get_message)
     }
 
     if (get_win == -1 && current->process->idle_event) set_event( current->process->idle_event );
-    queue->wake_mask = req->wake_mask;
-    queue->changed_mask = req->changed_mask;
+    set_queue_masks( queue, req->wake_mask, req->changed_mask );
     set_error( STATUS_PENDING );  /* FIXME */
 }
 